@@ -1,45 +1,56 @@
 #include "big_integer.h"
 
+#include "big_integer_tuning.h"
+#include "limb_kernels.h"
+
 #include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
 #include <cassert>
 #include <iostream>
+#include <limits>
+#include <latch>
 #include <numeric>
+#include <optional>
 #include <ostream>
 #include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
-static constexpr size_t EXP = 32;
-static constexpr uint64_t BASE = (1LL << EXP);
-static constexpr uint32_t INT_MOD = 1000000000;
-static constexpr uint32_t INT_BASE = 10;
-static constexpr size_t DIGITS_CNT = 9;
-
-uint32_t exp(uint32_t base, size_t power) {
-  uint32_t result = 1;
+
+using namespace limb_kernels;
+
+// x86-64 with 64-bit limbs adds long operands with AVX2/AVX-512 kernels picked by CPUID
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__SIZEOF_INT128__) && !defined(BIG_INTEGER_32BIT_LIMBS)
+#define BIG_INTEGER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// the largest power of ten that fits into a limb
+static constexpr size_t DIGITS_CNT = EXP == 64 ? 19 : 9;
+static constexpr limb_t INT_MOD = EXP == 64 ? 10000000000000000000ULL : 1000000000;
+static constexpr limb_t INT_BASE = 10;
+
+limb_t exp(limb_t base, size_t power) {
+  limb_t result = 1;
   for (; power > 0; --power) {
     result *= base;
   }
   return result;
 }
 
-template <typename T>
-static uint32_t ui_cast(T value) {
-  return static_cast<uint32_t>(value & std::numeric_limits<uint32_t>::max());
-}
-
-template <typename T>
-static uint64_t ull_cast(T value) {
-  return static_cast<uint64_t>(value);
-}
-
 size_t big_integer::length() const {
   return _data.size();
 }
 
-uint32_t& big_integer::operator[](size_t index) {
+limb_t& big_integer::operator[](size_t index) {
   return _data[index];
 }
 
-uint32_t big_integer::operator[](size_t index) const {
+limb_t big_integer::operator[](size_t index) const {
   return _data[index];
 }
 
@@ -65,20 +76,6 @@ bool big_integer::abs_great_or_eq(const big_integer& rhs) const {
   return true;
 }
 
-big_integer mul_uint(const big_integer& a, const uint32_t& b) {
-  big_integer result;
-  uint64_t carry = 0;
-  for (size_t i = 0; i < a.length(); i++) {
-    uint64_t tmp = static_cast<uint64_t>(a[i]) * b + carry;
-    result._data.push_back(ui_cast(tmp));
-    carry = tmp >> EXP;
-  }
-  if (carry != 0) {
-    result._data.push_back(ui_cast(carry));
-  }
-  return result;
-}
-
 void swap(big_integer& a, big_integer& b) {
   a._data.swap(b._data);
   std::swap(a._sign, b._sign);
@@ -96,505 +93,3071 @@ big_integer::big_integer(unsigned long a) : big_integer(static_cast<unsigned lon
 
 big_integer::big_integer(const big_integer& other) = default;
 
+big_integer::big_integer(big_integer&& other) noexcept = default;
+
 big_integer::big_integer(long long a) {
   if (a != 0) {
-    uint64_t b = ull_cast(a);
+    dlimb_t b = dlimb_cast(a);
     _sign = a < 0;
     if (_sign) {
       b = -b;
     }
-    _data = {ui_cast(b)};
+    _data = {limb_cast(b)};
     if (b >> EXP) {
-      _data.push_back(ui_cast(b >> EXP));
+      _data.push_back(limb_cast(b >> EXP));
     }
   }
 }
 
 big_integer::big_integer(unsigned long long a) {
-  _data = {ui_cast(a), ui_cast(a >> EXP)};
+  dlimb_t b = a;
+  _data = {limb_cast(b), limb_cast(b >> EXP)};
   trim();
 }
 
-big_integer::big_integer(const std::string& str) {
-  big_integer result;
+static limb_vector from_decimal(const char* first, const char* last, const std::vector<limb_vector>& powers);
+static std::vector<limb_vector> decimal_powers(size_t digits);
+static limb_vector from_radix(const char* first, const char* last, unsigned bits);
+static unsigned radix_bits(int base);
+static unsigned digit_value(char c);
+
+big_integer::big_integer(const std::string& str, int base) {
+  unsigned bits = radix_bits(base);
   size_t i = 0;
-  bool sign = false;
   if (str[0] == '-') {
-    sign = true;
+    _sign = true;
     i++;
   }
   if (i == str.size()) {
     throw std::invalid_argument("String must be not empty");
   }
-  for (; i < str.size(); i += DIGITS_CNT) {
-    uint32_t tmp = 0;
-    for (uint32_t j = 0; j < std::min(DIGITS_CNT, str.size() - i); j++) {
-      char ch = str[i + j];
-      if (ch < '0' || '9' < ch) {
-        throw std::invalid_argument("String characters must be ints");
-      }
-      tmp *= INT_BASE;
-      tmp += ch - '0';
+  for (size_t j = i; j < str.size(); j++) {
+    if (digit_value(str[j]) >= static_cast<unsigned>(base)) {
+      throw std::invalid_argument("String characters must be digits of the base");
     }
-    if (str.size() - i >= DIGITS_CNT) {
-      result = mul_uint(result, INT_MOD);
-    } else {
-      result = mul_uint(result, exp(INT_BASE, str.size() - i));
-    }
-    result += tmp;
   }
-  result._sign = sign;
-  swap(*this, result);
-  trim();
+  if (bits == 0) {
+    _data = from_decimal(str.data() + i, str.data() + str.size(), decimal_powers(str.size() - i));
+  } else {
+    _data = from_radix(str.data() + i, str.data() + str.size(), bits);
+  }
 }
 
 big_integer::~big_integer() = default;
 
 big_integer& big_integer::operator=(const big_integer& other) = default;
 
-static std::pair<uint32_t, uint32_t> add(uint32_t a, uint32_t b) {
-  return std::pair(a + b, UINT32_MAX - b < a);
-}
+big_integer& big_integer::operator=(big_integer&& other) noexcept = default;
 
-static std::pair<uint32_t, uint32_t> sub(const uint32_t& a, const uint32_t& b) {
-  return std::pair(a - b, a < b);
-}
+// Limb-array kernels on top of limb_kernels.h. All arrays are little-endian, `r` may alias `a` where noted.
 
-void big_integer::bit_negation(big_integer& a) {
-  for (auto& i : a._data) {
-    i = ~i;
-  }
-  if (a._sign) {
-    --a;
-  } else {
-    ++a;
-  }
-}
+#ifdef BIG_INTEGER_X86_KERNELS
+// Carry-lookahead across vector lanes: a lane generates a carry if its sum wraps and passes an incoming one on if the
+// sum is all ones. With the generate bits moved one lane up, one integer addition of the two lane masks ripples the
+// carries through runs of passing lanes and its bit `lanes` is the carry out of the vector. Subtraction is the same
+// with borrows, where a zero difference passes an incoming borrow on. The kernels clear the upper register halves
+// before returning to scalar code, GCC omits the vzeroupper before a tail call.
 
-big_integer& big_integer::shift_left(big_integer& a, size_t shift) {
-  a._data.insert(a._data.begin(), shift, 0);
-  return a;
+// the lanes of a 4-lane mask as 0 or 1
+__attribute__((target("avx2"))) static __m256i lane_bits_avx2(unsigned mask) {
+  __m256i shifted = _mm256_srlv_epi64(_mm256_set1_epi64x(mask), _mm256_setr_epi64x(0, 1, 2, 3));
+  return _mm256_and_si256(shifted, _mm256_set1_epi64x(1));
 }
 
-bool big_integer::sub_in_pos(big_integer& lhs, const big_integer& rhs, size_t pos) {
-  uint32_t carry = 0;
-  for (size_t i = 0; i < rhs.length() || carry > 0; i++) {
-    auto p = sub(lhs[i + pos], carry);
-    carry = p.second;
-    if (i < rhs.length()) {
-      p = sub(p.first, rhs[i]);
-    }
-    carry = std::max(p.second, carry);
-    lhs[i + pos] = p.first;
+__attribute__((target("avx2"))) static limb_t add_n_avx2(limb_t* r, const limb_t* a, const limb_t* b, size_t n,
+                                                          limb_t carry) {
+  const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  unsigned c = carry;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i s = _mm256_add_epi64(x, y);
+    __m256i wrapped = _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign), _mm256_xor_si256(s, sign));
+    unsigned generate = _mm256_movemask_pd(_mm256_castsi256_pd(wrapped));
+    unsigned propagate = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(s, ones)));
+    unsigned sum = (generate << 1 | c) + propagate;
+    c = sum >> 4;
+    s = _mm256_add_epi64(s, lane_bits_avx2(sum ^ propagate));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), s);
   }
-  return carry;
+  _mm256_zeroupper();
+  return add_n_scalar(r + i, a + i, b + i, n - i, c);
 }
 
-template <bool ignore_last_carry>
-void big_integer::add_in_pos(big_integer& lhs, const big_integer& rhs, size_t pos) {
-  uint32_t carry = 0;
-  for (size_t i = 0; i < rhs.length() || (carry && !ignore_last_carry); i++) {
-    if (i + pos == lhs.length()) {
-      lhs._data.push_back(0);
-    }
-    auto p = add(lhs[i + pos], carry);
-    carry = p.second;
-    if (i < rhs.length()) {
-      p = add(p.first, rhs[i]);
-    }
-    carry = std::max(p.second, carry);
-    lhs[i + pos] = p.first;
+__attribute__((target("avx2"))) static limb_t sub_n_avx2(limb_t* r, const limb_t* a, const limb_t* b, size_t n,
+                                                          limb_t borrow) {
+  const __m256i sign = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  unsigned c = borrow;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i d = _mm256_sub_epi64(x, y);
+    __m256i wrapped = _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign), _mm256_xor_si256(x, sign));
+    unsigned generate = _mm256_movemask_pd(_mm256_castsi256_pd(wrapped));
+    unsigned propagate = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(d, _mm256_setzero_si256())));
+    unsigned sum = (generate << 1 | c) + propagate;
+    c = sum >> 4;
+    d = _mm256_sub_epi64(d, lane_bits_avx2(sum ^ propagate));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), d);
   }
+  _mm256_zeroupper();
+  return sub_n_scalar(r + i, a + i, b + i, n - i, c);
 }
 
-template <bool ignore_sign>
-void big_integer::add_with_ignore(const big_integer& rhs) {
-  if (!ignore_sign && _sign != rhs._sign) {
-    sub_with_ignore<true>(rhs);
-  } else {
-    add_in_pos<false>(*this, rhs, 0);
-    trim();
+__attribute__((target("avx512f"))) static limb_t add_n_avx512(limb_t* r, const limb_t* a, const limb_t* b, size_t n,
+                                                               limb_t carry) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  unsigned c = carry;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i x = _mm512_loadu_si512(a + i);
+    __m512i s = _mm512_add_epi64(x, _mm512_loadu_si512(b + i));
+    unsigned generate = _mm512_cmplt_epu64_mask(s, x);
+    unsigned propagate = _mm512_cmpeq_epi64_mask(s, ones);
+    unsigned sum = (generate << 1 | c) + propagate;
+    c = sum >> 8;
+    s = _mm512_mask_sub_epi64(s, static_cast<__mmask8>(sum ^ propagate), s, ones);
+    _mm512_storeu_si512(r + i, s);
   }
+  _mm256_zeroupper();
+  return add_n_scalar(r + i, a + i, b + i, n - i, c);
 }
 
-template <bool ignore_sign>
-void big_integer::sub_with_ignore(const big_integer& rhs) {
-  if (!ignore_sign && _sign != rhs._sign) {
-    add_with_ignore<true>(rhs);
-  } else {
-    if (abs_great_or_eq(rhs)) {
-      sub_in_pos(*this, rhs, 0);
-    } else {
-      big_integer tmp = rhs;
-      tmp.sub_with_ignore<ignore_sign>(*this);
-      tmp._sign ^= !ignore_sign;
-      swap(*this, tmp);
-    }
-    trim();
+__attribute__((target("avx512f"))) static limb_t sub_n_avx512(limb_t* r, const limb_t* a, const limb_t* b, size_t n,
+                                                               limb_t borrow) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  unsigned c = borrow;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i x = _mm512_loadu_si512(a + i);
+    __m512i y = _mm512_loadu_si512(b + i);
+    __m512i d = _mm512_sub_epi64(x, y);
+    unsigned generate = _mm512_cmplt_epu64_mask(x, y);
+    unsigned propagate = _mm512_cmpeq_epi64_mask(d, _mm512_setzero_si512());
+    unsigned sum = (generate << 1 | c) + propagate;
+    c = sum >> 8;
+    d = _mm512_mask_add_epi64(d, static_cast<__mmask8>(sum ^ propagate), d, ones);
+    _mm512_storeu_si512(r + i, d);
   }
+  _mm256_zeroupper();
+  return sub_n_scalar(r + i, a + i, b + i, n - i, c);
 }
 
-big_integer& big_integer::operator+=(const big_integer& rhs) {
-  add_with_ignore<false>(rhs);
-  return *this;
-}
+using add_n_kernel = limb_t (*)(limb_t*, const limb_t*, const limb_t*, size_t, limb_t);
 
-big_integer& big_integer::operator-=(const big_integer& rhs) {
-  sub_with_ignore<false>(rhs);
-  return *this;
-}
+struct add_sub_kernels {
+  add_n_kernel add;
+  add_n_kernel sub;
+};
 
-big_integer& big_integer::operator*=(const big_integer& rhs) {
-  big_integer result;
-  result._data.resize(length() + rhs.length());
-  for (size_t i = 0; i < length(); i++) {
-    uint64_t carry = 0;
-    for (size_t j = 0; j < rhs.length() || carry > 0; j++) {
-      uint64_t cur = result[i + j] + ull_cast(_data[i]) * (j < rhs.length() ? rhs[j] : 0) + carry;
-      result[i + j] = ui_cast(cur);
-      carry = cur >> EXP;
+// chosen on first use, so that additions during static initialization of other translation units are safe
+static const add_sub_kernels& vector_kernels() {
+  static const add_sub_kernels kernels = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return add_sub_kernels{add_n_avx512, sub_n_avx512};
     }
-  }
-  result._sign = _sign ^ rhs._sign;
-  result.trim();
-  swap(*this, result);
-  return *this;
+    if (__builtin_cpu_supports("avx2")) {
+      return add_sub_kernels{add_n_avx2, sub_n_avx2};
+    }
+    return add_sub_kernels{add_n_scalar, sub_n_scalar};
+  }();
+  return kernels;
 }
+#endif
 
-template <bool return_remainder>
-big_integer& big_integer::abstract_division(const big_integer& rhs) {
-  if (rhs == 0) {
-    throw std::invalid_argument("Cannot divide by zero");
-  }
-  if (rhs.length() == 1) {
-    if (return_remainder) {
-      auto p = *this;
-      p.div_uint(rhs[0]);
-      p._sign ^= rhs._sign;
-      *this -= p * rhs;
-    } else {
-      div_uint(rhs[0]);
-      _sign ^= rhs._sign;
-    }
-    return *this;
-  }
-  big_integer dividend = *this;
-  big_integer divisor = rhs;
-  dividend._sign = false;
-  divisor._sign = false;
-  if (divisor > dividend) {
-    return return_remainder ? *this : *this = 0;
-  }
-  uint64_t d = BASE / (ull_cast(rhs._data.back()) + 1);
-  size_t divisor_len = rhs.length();
-  size_t len_diff = length() - divisor_len;
-  if (d != 1) {
-    dividend = mul_uint(dividend, d);
-    divisor = mul_uint(divisor, d);
-  }
-  if (dividend.length() == len_diff + divisor_len) {
-    dividend._data.push_back(0);
-  }
-  std::vector<uint32_t> q;
-  for (size_t j = len_diff + 1; j > 0; j--) {
-    uint64_t two_digits = ((ull_cast(dividend[j + divisor_len - 1]) << EXP) + dividend[j + divisor_len - 2]);
-    uint64_t poss_q = two_digits / divisor[divisor_len - 1];
-    uint64_t poss_r = two_digits % divisor[divisor_len - 1];
-    assert(divisor_len >= 2);
-    assert(j + divisor_len >= 3);
-    if (poss_q == BASE || poss_q * divisor[divisor_len - 2] > BASE * poss_r + dividend[j + divisor_len - 3]) {
-      --poss_q;
-      poss_r += divisor[divisor_len - 1];
-      if (poss_r < BASE &&
-          (poss_q == BASE || poss_q * divisor[divisor_len - 2] > BASE * poss_r + dividend[j + divisor_len - 3])) {
-        --poss_q;
-      }
-    }
-    big_integer try_subtrahend = mul_uint(divisor, poss_q);
-    bool flag = sub_in_pos(dividend, try_subtrahend, j - 1);
-    if (flag) {
-      --poss_q;
-      add_in_pos<true>(dividend, divisor, j - 1);
-    }
-    q.push_back(poss_q);
-  }
-  if (return_remainder) {
-    std::swap(_data, dividend._data);
-    div_uint(d);
-  } else {
-    std::reverse(q.begin(), q.end());
-    std::swap(_data, q);
-    _sign ^= rhs._sign;
+static limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t carry) {
+#ifdef BIG_INTEGER_X86_KERNELS
+  if (n >= VECTOR_ADD_THRESHOLD) {
+    return vector_kernels().add(r, a, b, n, carry);
   }
-  trim();
-  return *this;
+#endif
+  return add_n_scalar(r, a, b, n, carry);
 }
 
-big_integer& big_integer::operator/=(const big_integer& rhs) {
-  return *this = abstract_division<false>(rhs);
+static limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t borrow) {
+#ifdef BIG_INTEGER_X86_KERNELS
+  if (n >= VECTOR_ADD_THRESHOLD) {
+    return vector_kernels().sub(r, a, b, n, borrow);
+  }
+#endif
+  return sub_n_scalar(r, a, b, n, borrow);
 }
 
-big_integer& big_integer::operator%=(const big_integer& rhs) {
-  return *this = abstract_division<true>(rhs);
+// r[0..n) = a[0..n) + b[0..m), n >= m, r may alias a or b
+static limb_t add_limbs(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+  limb_t carry = add_n(r, a, b, m, 0);
+  size_t i = m;
+  for (; i < n && carry != 0; i++) {
+    r[i] = a[i] + 1;
+    carry = r[i] == 0;
+  }
+  if (r != a) {
+    std::copy(a + i, a + n, r + i);
+  }
+  return carry;
 }
 
-template <class Operation>
-void big_integer::bit_operation(const big_integer& rhs) {
-  Operation operation;
-  size_t len = std::max(length(), rhs.length());
-  _data.resize(len);
-  if (_sign) {
-    bit_negation(*this);
+// r[0..n) = a[0..n) - b[0..m), n >= m, r may alias a or b; returns borrow
+static limb_t sub_limbs(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+  limb_t borrow = sub_n(r, a, b, m, 0);
+  size_t i = m;
+  for (; i < n && borrow != 0; i++) {
+    borrow = a[i] == 0;
+    r[i] = a[i] - 1;
   }
-  big_integer b = rhs;
-  if (rhs._sign) {
-    bit_negation(b);
+  if (r != a) {
+    std::copy(a + i, a + n, r + i);
   }
-  for (size_t i = 0; i < len; i++) {
-    _data[i] = operation(_data[i], (i < b.length()) ? b[i] : 0);
+  return borrow;
+}
+
+// |this| += |rhs|
+void big_integer::add_abs(const big_integer& rhs) {
+  size_t n = length();
+  size_t m = rhs.length();
+  _data.resize(std::max(n, m));
+  limb_t* r = _data.data();
+  limb_t carry = n >= m ? add_limbs(r, r, n, rhs._data.data(), m) : add_limbs(r, rhs._data.data(), m, r, n);
+  if (carry != 0) {
+    _data.push_back(carry);
   }
-  _sign = operation(_sign, rhs._sign);
-  if (_sign) {
-    bit_negation(*this);
+}
+
+// |this| -= |rhs|, the sign flips if |rhs| > |this|
+void big_integer::sub_abs(const big_integer& rhs) {
+  size_t n = length();
+  size_t m = rhs.length();
+  if (abs_great_or_eq(rhs)) {
+    sub_limbs(_data.data(), _data.data(), n, rhs._data.data(), m);
+  } else {
+    _data.resize(m);
+    sub_limbs(_data.data(), rhs._data.data(), m, _data.data(), n);
+    _sign = !_sign;
   }
   trim();
+  _sign = _sign && !eq_zero();
 }
 
-big_integer& big_integer::operator&=(const big_integer& rhs) {
-  bit_operation<std::bit_and<uint32_t>>(rhs);
+big_integer& big_integer::operator+=(const big_integer& rhs) {
+  if (_sign == rhs._sign) {
+    add_abs(rhs);
+  } else {
+    sub_abs(rhs);
+  }
   return *this;
 }
 
-big_integer& big_integer::operator|=(const big_integer& rhs) {
-  bit_operation<std::bit_or<uint32_t>>(rhs);
+big_integer& big_integer::operator-=(const big_integer& rhs) {
+  if (_sign != rhs._sign) {
+    add_abs(rhs);
+  } else {
+    sub_abs(rhs);
+  }
   return *this;
 }
 
-big_integer& big_integer::operator^=(const big_integer& rhs) {
-  bit_operation<std::bit_xor<uint32_t>>(rhs);
-  return *this;
+// r[0..n) = a[0..n) + (b[0..n) << shift), 0 < shift < EXP, returns the carry together with the bits shifted out
+static limb_t addlsh_limbs(limb_t* r, const limb_t* a, const limb_t* b, size_t n, size_t shift) {
+  limb_t out = 0;
+  limb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = dlimb_cast(a[i]) + ((b[i] << shift) | out) + carry;
+    out = b[i] >> (EXP - shift);
+    r[i] = limb_cast(cur);
+    carry = limb_cast(cur >> EXP);
+  }
+  return out + carry;
 }
 
-big_integer& big_integer::operator<<=(int rhs) {
-  size_t size = length();
-  size_t big_shift = rhs / EXP;
-  size_t small_shift = rhs % EXP;
-  _data.resize(length() + big_shift + 1);
-  for (size_t i = size; i > 0; i--) {
-    _data[i + big_shift] |= _data[i - 1] >> std::min(EXP - 1, EXP - small_shift);
-    _data[i + big_shift - 1] = _data[i - 1] << (small_shift);
+// a[0..n) = -a[0..n) in two's complement
+static void negate_limbs(limb_t* a, size_t n) {
+  limb_t carry = 1;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = dlimb_cast(~a[i]) + carry;
+    a[i] = limb_cast(cur);
+    carry = limb_cast(cur >> EXP);
   }
-  for (size_t i = big_shift; i > 0; i--) {
-    _data[i - 1] = 0;
-  }
-  trim();
-  return *this;
 }
 
-big_integer& big_integer::operator>>=(int rhs) {
-  size_t size = length();
-  if (_sign) {
-    bit_negation(*this);
+// a[0..n) /= d for a two's complement value that d divides: the power-of-two part of d
+// is an arithmetic shift, the odd part is a multiplication by its inverse modulo BASE^n.
+static void divexact_limbs(limb_t* a, size_t n, limb_t d) {
+  size_t shift = std::countr_zero(d);
+  if (shift != 0) {
+    limb_t fill = (a[n - 1] >> (EXP - 1)) != 0 ? std::numeric_limits<limb_t>::max() : 0;
+    for (size_t i = 0; i < n; i++) {
+      a[i] = (a[i] >> shift) | ((i + 1 < n ? a[i + 1] : fill) << (EXP - shift));
+    }
+    d >>= shift;
   }
-  size_t big_shift = rhs / EXP;
-  size_t small_shift = rhs % EXP;
-  uint32_t complete = _sign ? ui_cast(BASE - 1) : 0;
-  for (size_t i = 0; i < size - big_shift; i++) {
-    _data[i] = _data[i + big_shift] >> small_shift;
-    _data[i] |= ((i + big_shift + 1 < _data.size()) ? _data[i + big_shift + 1] : complete)
-             << std::min(EXP - 1, EXP - small_shift);
+  if (d == 1) {
+    return;
   }
-  _data.resize(size - big_shift);
-  if (_sign) {
-    bit_negation(*this);
+  // every Newton step doubles the number of correct low bits, d * d = 1 modulo 8
+  limb_t inv = d;
+  for (size_t bits = 3; bits < EXP; bits *= 2) {
+    inv *= 2 - d * inv;
+  }
+  limb_t borrow = 0;
+  for (size_t i = 0; i < n; i++) {
+    limb_t cur = a[i] - borrow;
+    borrow = cur > a[i];
+    a[i] = cur * inv;
+    borrow += limb_cast((dlimb_cast(a[i]) * d) >> EXP);
   }
-  trim();
-  return *this;
-}
-
-big_integer big_integer::operator+() const {
-  return *this;
 }
 
-big_integer big_integer::operator-() const {
-  big_integer tmp = *this;
-  tmp._sign = !tmp._sign;
-  return tmp;
+// r[0..n+m) = a[0..n) * b[0..m)
+static void mul_basecase(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+  std::fill(r, r + n + m, 0);
+  for (size_t i = 0; i < m; i++) {
+    r[i + n] = addmul_limbs(r + i, a, n, b[i]);
+  }
 }
 
-big_integer big_integer::operator~() const {
-  big_integer result = *this;
-  result._sign = !result._sign;
-  --result;
-  return result;
+// r[0..2n) = a[0..n)^2, every cross product is computed once and doubled
+static void sqr_basecase(limb_t* r, const limb_t* a, size_t n) {
+  std::fill(r, r + 2 * n, 0);
+  for (size_t i = 0; i + 1 < n; i++) {
+    r[i + n] = addmul_limbs(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+  }
+  limb_t top = 0;
+  for (size_t i = 0; i < 2 * n; i++) {
+    limb_t cur = r[i];
+    r[i] = (cur << 1) | top;
+    top = cur >> (EXP - 1);
+  }
+  dlimb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t sq = dlimb_cast(a[i]) * a[i];
+    dlimb_t lo = r[2 * i] + (sq & (BASE - 1)) + carry;
+    r[2 * i] = limb_cast(lo);
+    dlimb_t hi = r[2 * i + 1] + (sq >> EXP) + (lo >> EXP);
+    r[2 * i + 1] = limb_cast(hi);
+    carry = hi >> EXP;
+  }
 }
 
-big_integer& big_integer::operator++() {
-  if (!_sign) {
-    uint32_t carry = 1;
-    for (size_t i = 0; i < _data.size() && carry > 0; ++i) {
-      uint64_t sum = _data[i] + carry;
-      _data[i] = ui_cast(sum);
-      carry = sum >> EXP;
-    }
-    if (carry > 0) {
-      _data.push_back(ui_cast(carry));
-    }
+// r[0..k) = |x[0..k) - y[0..h)|, k >= h, returns true if x < y
+static bool abs_diff_limbs(limb_t* r, const limb_t* x, size_t k, const limb_t* y, size_t h) {
+  bool less = std::all_of(x + h, x + k, [](limb_t v) { return v == 0; }) && cmp_limbs(x, y, h) < 0;
+  if (less) {
+    sub_limbs(r, y, h, x, h);
+    std::fill(r + h, r + k, 0);
   } else {
-    _sign = false;
-    --(*this);
-    if (!eq_zero()) {
-      _sign = true;
-    }
+    sub_limbs(r, x, k, y, h);
   }
-  return *this;
+  return less;
 }
 
-big_integer big_integer::operator++(int) {
-  big_integer tmp = *this;
-  ++(*this);
-  return tmp;
+static size_t karatsuba_scratch(size_t n) {
+  size_t result = 0;
+  while (n >= std::min(KARATSUBA_THRESHOLD, KARATSUBA_SQR_THRESHOLD)) {
+    n -= n / 2;
+    result += 4 * n;
+  }
+  return result;
 }
 
-big_integer& big_integer::operator--() {
-  if (!_sign) {
-    if (eq_zero()) {
-      _sign = true;
-      _data.push_back(1);
-    } else {
-      uint32_t carry = 1;
-      for (size_t i = 0; i < _data.size() && carry > 0; ++i) {
-        uint64_t sum = _data[i] - carry;
-        _data[i] = ui_cast(sum);
-        carry = sum >> EXP;
-      }
-    }
-    trim();
+// Given r[0..2h) = a0 * b0, r[2h..2n) = a1 * b1 and t = |a1 - a0| * |b1 - b0|,
+// adds the middle term a0 * b1 + a1 * b0 = a0 * b0 + a1 * b1 -+ t at position h.
+// `m` is 2k limbs of scratch.
+static void karatsuba_combine(limb_t* r, size_t h, size_t k, const limb_t* t, bool t_negative, limb_t* m) {
+  size_t n = h + k;
+  limb_t carry = add_limbs(m, r + 2 * h, 2 * k, r, 2 * h);
+  if (t_negative) {
+    carry += add_limbs(m, m, 2 * k, t, 2 * k);
   } else {
-    _sign = false;
-    ++(*this);
-    _sign = true;
+    carry -= sub_limbs(m, m, 2 * k, t, 2 * k);
   }
-  return *this;
+  add_limbs(r + h, r + h, 2 * n - h, m, 2 * k);
+  add_limbs(r + h + 2 * k, r + h + 2 * k, h, &carry, 1);
 }
 
-big_integer big_integer::operator--(int) {
-  big_integer tmp = big_integer(*this);
-  --(*this);
-  return tmp;
+// r[0..2n) = a[0..n) * b[0..n)
+static void karatsuba_mul(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t* scratch) {
+  if (n < KARATSUBA_THRESHOLD) {
+    mul_basecase(r, a, n, b, n);
+    return;
+  }
+  size_t h = n / 2;
+  size_t k = n - h;
+  limb_t* da = scratch;
+  limb_t* db = scratch + k;
+  limb_t* t = scratch + 2 * k;
+  limb_t* next = scratch + 4 * k;
+  bool t_negative = abs_diff_limbs(da, a + h, k, a, h) != abs_diff_limbs(db, b + h, k, b, h);
+  karatsuba_mul(t, da, db, k, next);
+  karatsuba_mul(r, a, b, h, next);
+  karatsuba_mul(r + 2 * h, a + h, b + h, k, next);
+  karatsuba_combine(r, h, k, t, t_negative, scratch);
 }
 
-big_integer operator+(const big_integer& a, const big_integer& b) {
-  return big_integer(a) += b;
+// r[0..2n) = a[0..n)^2
+static void karatsuba_sqr(limb_t* r, const limb_t* a, size_t n, limb_t* scratch) {
+  if (n < KARATSUBA_SQR_THRESHOLD) {
+    sqr_basecase(r, a, n);
+    return;
+  }
+  size_t h = n / 2;
+  size_t k = n - h;
+  limb_t* da = scratch;
+  limb_t* t = scratch + 2 * k;
+  limb_t* next = scratch + 4 * k;
+  abs_diff_limbs(da, a + h, k, a, h);
+  karatsuba_sqr(t, da, k, next);
+  karatsuba_sqr(r, a, h, next);
+  karatsuba_sqr(r + 2 * h, a + h, k, next);
+  karatsuba_combine(r, h, k, t, false, scratch);
 }
 
-big_integer operator-(const big_integer& a, const big_integer& b) {
-  return big_integer(a) -= b;
-}
+static void mul_balanced(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t* scratch);
+static size_t mul_scratch(size_t n);
 
-big_integer operator*(const big_integer& a, const big_integer& b) {
-  return big_integer(a) *= b;
+// r[0..n) -= a[0..m) * b with the borrow propagated through the top n - m limbs
+static void submul_wide(limb_t* r, size_t n, const limb_t* a, size_t m, limb_t b) {
+  limb_t borrow = submul_limbs(r, a, m, b);
+  sub_limbs(r + m, r + m, n - m, &borrow, 1);
 }
 
-big_integer operator/(const big_integer& a, const big_integer& b) {
-  return big_integer(a) /= b;
+// r[0..n) += a[0..m), where a is a nonnegative coefficient that fits into n limbs
+static void add_coefficient(limb_t* r, size_t n, const limb_t* a, size_t m) {
+  assert(std::all_of(a + std::min(n, m), a + m, [](limb_t v) { return v == 0; }));
+  m = std::min(n, m);
+  add_limbs(r, r, n, a, m);
 }
 
-big_integer operator%(const big_integer& a, const big_integer& b) {
-  return big_integer(a) %= b;
+// scratch of the pieces of a Toom split into k-limb parts with an s-limb top part
+static size_t toom_pieces_scratch(size_t k, size_t s) {
+  return std::max({mul_scratch(s), mul_scratch(k), mul_scratch(k + 1)});
 }
 
-big_integer operator&(const big_integer& a, const big_integer& b) {
-  return big_integer(a) &= b;
+static size_t toom3_scratch(size_t n) {
+  size_t k = (n + 2) / 3;
+  return 6 * (k + 1) + 4 * (2 * k + 2) + toom_pieces_scratch(k, n - 2 * k);
 }
 
-big_integer operator|(const big_integer& a, const big_integer& b) {
-  return big_integer(a) |= b;
-}
+// Toom-3 over the points 0, 1, -1, 2, inf, see "Modern Computer Arithmetic", algorithm 1.4.
+// Evaluations take k + 1 limbs; the interpolation runs in two's complement on 2k + 2 limbs,
+// which holds every intermediate value, so every division in it is exact.
+static void toom3_mul(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t* scratch) {
+  size_t k = (n + 2) / 3;
+  size_t s = n - 2 * k;
+  size_t w = 2 * k + 2;
+  assert(s > 0);
+  limb_t* v1 = scratch + 6 * (k + 1);
+  limb_t* vm1 = v1 + w;
+  limb_t* v2 = vm1 + w;
+  limb_t* t1 = v2 + w;
+  limb_t* next = t1 + w;
+
+  // x(1), |x(-1)| and x(2), returns whether x(-1) is negative
+  auto evaluate = [k, s](const limb_t* x, limb_t* p1, limb_t* m1, limb_t* p2) {
+    p1[k] = add_limbs(p1, x, k, x + 2 * k, s);
+    bool negative = abs_diff_limbs(m1, p1, k + 1, x + k, k);
+    p1[k] += add_limbs(p1, p1, k, x + k, k);
+    add_limbs(p2, p1, k + 1, x + 2 * k, s);
+    lshift_limbs(p2, p2, k + 1, 1);
+    sub_limbs(p2, p2, k + 1, x, k);
+    return negative;
+  };
+  limb_t* pa = scratch;
+  limb_t* pb = pa + 3 * (k + 1);
+  bool vm1_negative = evaluate(a, pa, pa + k + 1, pa + 2 * (k + 1));
+  if (a == b) {
+    pb = pa;
+    vm1_negative = false;
+  } else {
+    vm1_negative ^= evaluate(b, pb, pb + k + 1, pb + 2 * (k + 1));
+  }
 
-big_integer operator^(const big_integer& a, const big_integer& b) {
-  return big_integer(a) ^= b;
+  mul_balanced(r, a, b, k, next);
+  mul_balanced(r + 4 * k, a + 2 * k, b + 2 * k, s, next);
+  mul_balanced(v1, pa, pb, k + 1, next);
+  mul_balanced(vm1, pa + k + 1, pb + k + 1, k + 1, next);
+  mul_balanced(v2, pa + 2 * (k + 1), pb + 2 * (k + 1), k + 1, next);
+  if (vm1_negative) {
+    negate_limbs(vm1, w);
+  }
+  const limb_t* v0 = r;
+  const limb_t* vinf = r + 4 * k;
+
+  // t1 = (3 v0 + 2 v(-1) + v2) / 6 - 2 vinf
+  t1[2 * k] = mul_1_limbs(t1, v0, 2 * k, 3);
+  t1[2 * k + 1] = 0;
+  add_limbs(t1, t1, w, vm1, w);
+  add_limbs(t1, t1, w, vm1, w);
+  add_limbs(t1, t1, w, v2, w);
+  divexact_limbs(t1, w, 6);
+  submul_wide(t1, w, vinf, 2 * s, 2);
+  // t2 = (v1 + v(-1)) / 2, kept in vm1
+  add_limbs(vm1, vm1, w, v1, w);
+  divexact_limbs(vm1, w, 2);
+  // c1 = v1 - t1, c2 = t2 - v0 - vinf, c3 = t1 - t2
+  sub_limbs(v1, v1, w, t1, w);
+  sub_limbs(t1, t1, w, vm1, w);
+  sub_limbs(vm1, vm1, w, v0, 2 * k);
+  sub_limbs(vm1, vm1, w, vinf, 2 * s);
+
+  std::fill(r + 2 * k, r + 4 * k, 0);
+  add_coefficient(r + k, 2 * n - k, v1, w);
+  add_coefficient(r + 2 * k, 2 * n - 2 * k, vm1, w);
+  add_coefficient(r + 3 * k, 2 * n - 3 * k, t1, w);
 }
 
-big_integer operator<<(const big_integer& a, int b) {
-  return big_integer(a) <<= b;
+static size_t toom4_scratch(size_t n) {
+  size_t k = (n + 3) / 4;
+  return 14 * (k + 1) + 7 * (2 * k + 2) + toom_pieces_scratch(k, n - 3 * k);
 }
 
-big_integer operator>>(const big_integer& a, int b) {
-  return big_integer(a) >>= b;
-}
+// Toom-4 over the points 0, 1, -1, 2, -2, 3, inf. The interpolation separates even and odd
+// coefficients, so that it only divides exactly by small constants; like in toom3_mul it runs
+// in two's complement on 2k + 2 limbs.
+static void toom4_mul(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t* scratch) {
+  size_t k = (n + 3) / 4;
+  size_t s = n - 3 * k;
+  size_t w = 2 * k + 2;
+  assert(s > 0);
+  limb_t* even = scratch + 12 * (k + 1);
+  limb_t* odd = even + k + 1;
+  limb_t* w1 = odd + k + 1;
+  limb_t* wm1 = w1 + w;
+  limb_t* w2 = wm1 + w;
+  limb_t* wm2 = w2 + w;
+  limb_t* w3 = wm2 + w;
+  limb_t* t = w3 + w;
+  limb_t* u = t + w;
+  limb_t* next = u + w;
+
+  // x(1), |x(-1)|, x(2), |x(-2)|, x(3); returns whether x(-1) and x(-2) are negative
+  auto evaluate = [k, s, even, odd](const limb_t* x, limb_t* p) {
+    limb_t* p1 = p;
+    limb_t* m1 = p1 + k + 1;
+    limb_t* p2 = m1 + k + 1;
+    limb_t* m2 = p2 + k + 1;
+    limb_t* p3 = m2 + k + 1;
+    const limb_t* x0 = x;
+    const limb_t* x1 = x + k;
+    const limb_t* x2 = x + 2 * k;
+    const limb_t* x3 = x + 3 * k;
+
+    even[k] = add_limbs(even, x0, k, x2, k);
+    odd[k] = add_limbs(odd, x1, k, x3, s);
+    add_limbs(p1, even, k + 1, odd, k + 1);
+    bool m1_negative = abs_diff_limbs(m1, even, k + 1, odd, k + 1);
+
+    even[k] = addlsh_limbs(even, x0, x2, k, 2);
+    std::fill(odd + s, odd + k + 1, 0);
+    odd[s] = lshift_limbs(odd, x3, s, 2);
+    odd[k] += add_limbs(odd, odd, k, x1, k);
+    lshift_limbs(odd, odd, k + 1, 1);
+    add_limbs(p2, even, k + 1, odd, k + 1);
+    bool m2_negative = abs_diff_limbs(m2, even, k + 1, odd, k + 1);
+
+    std::fill(p3 + s, p3 + k + 1, 0);
+    std::copy(x3, x3 + s, p3);
+    for (const limb_t* xi : {x2, x1, x0}) {
+      mul_1_limbs(p3, p3, k + 1, 3);
+      add_limbs(p3, p3, k + 1, xi, k);
+    }
+    return std::pair(m1_negative, m2_negative);
+  };
+  limb_t* pa = scratch;
+  limb_t* pb = pa + 6 * (k + 1);
+  auto [wm1_negative, wm2_negative] = evaluate(a, pa);
+  if (a == b) {
+    pb = pa;
+    wm1_negative = wm2_negative = false;
+  } else {
+    auto [m1_negative, m2_negative] = evaluate(b, pb);
+    wm1_negative ^= m1_negative;
+    wm2_negative ^= m2_negative;
+  }
 
-bool operator==(const big_integer& a, const big_integer& b) {
-  return (a.eq_zero() && b.eq_zero()) || (a._sign == b._sign && a._data == b._data);
+  mul_balanced(r, a, b, k, next);
+  mul_balanced(r + 6 * k, a + 3 * k, b + 3 * k, s, next);
+  limb_t* products[] = {w1, wm1, w2, wm2, w3};
+  for (size_t i = 0; i < 5; i++) {
+    mul_balanced(products[i], pa + i * (k + 1), pb + i * (k + 1), k + 1, next);
+  }
+  if (wm1_negative) {
+    negate_limbs(wm1, w);
+  }
+  if (wm2_negative) {
+    negate_limbs(wm2, w);
+  }
+  const limb_t* c0 = r;
+  const limb_t* c6 = r + 6 * k;
+
+  // even coefficients: e1 = c0 + c2 + c4 + c6 and e2 = c0 + 4 c2 + 16 c4 + 64 c6
+  // odd coefficients: o1 = c1 + c3 + c5, o2 = c1 + 4 c3 + 16 c5 and o3 = c1 + 9 c3 + 81 c5
+  add_limbs(t, w1, w, wm1, w);
+  sub_limbs(w1, w1, w, wm1, w);
+  divexact_limbs(w1, w, 2);
+  limb_t* o1 = w1;
+  add_limbs(u, w2, w, wm2, w);
+  sub_limbs(w2, w2, w, wm2, w);
+  divexact_limbs(w2, w, 4);
+  limb_t* o2 = w2;
+
+  // s1 = c2 + c4 = e1 - c0 - c6, s2 = c2 + 4 c4 = (e2 - c0 - 64 c6) / 4
+  divexact_limbs(t, w, 2);
+  sub_limbs(t, t, w, c0, 2 * k);
+  sub_limbs(t, t, w, c6, 2 * s);
+  divexact_limbs(u, w, 2);
+  sub_limbs(u, u, w, c0, 2 * k);
+  submul_wide(u, w, c6, 2 * s, 64);
+  divexact_limbs(u, w, 4);
+  // c4 = (s2 - s1) / 3 and c2 = s1 - c4
+  sub_limbs(u, u, w, t, w);
+  divexact_limbs(u, w, 3);
+  sub_limbs(t, t, w, u, w);
+  limb_t* c2 = t;
+  limb_t* c4 = u;
+
+  // o3 = (w3 - c0 - 9 c2 - 81 c4 - 729 c6) / 3
+  sub_limbs(w3, w3, w, c0, 2 * k);
+  submul_limbs(w3, c2, w, 9);
+  submul_limbs(w3, c4, w, 81);
+  submul_wide(w3, w, c6, 2 * s, 729);
+  divexact_limbs(w3, w, 3);
+  limb_t* o3 = w3;
+  // d1 = c3 + 5 c5 = (o2 - o1) / 3, d2 = c3 + 10 c5 = (o3 - o1) / 8, c5 = (d2 - d1) / 5
+  sub_limbs(o2, o2, w, o1, w);
+  divexact_limbs(o2, w, 3);
+  sub_limbs(o3, o3, w, o1, w);
+  divexact_limbs(o3, w, 8);
+  sub_limbs(o3, o3, w, o2, w);
+  divexact_limbs(o3, w, 5);
+  limb_t* c5 = o3;
+  // c3 = d1 - 5 c5, c1 = o1 - c3 - c5
+  submul_limbs(o2, c5, w, 5);
+  limb_t* c3 = o2;
+  sub_limbs(o1, o1, w, c3, w);
+  sub_limbs(o1, o1, w, c5, w);
+  limb_t* c1 = o1;
+
+  std::fill(r + 2 * k, r + 6 * k, 0);
+  add_coefficient(r + k, 2 * n - k, c1, w);
+  add_coefficient(r + 2 * k, 2 * n - 2 * k, c2, w);
+  add_coefficient(r + 3 * k, 2 * n - 3 * k, c3, w);
+  add_coefficient(r + 4 * k, 2 * n - 4 * k, c4, w);
+  add_coefficient(r + 5 * k, 2 * n - 5 * k, c5, w);
 }
 
-bool operator>(const big_integer& a, const big_integer& b) {
-  if (a._sign != b._sign) {
-    return !a._sign;
+namespace {
+// One of the threads that run a parallel multiplication together: all of them go through the same steps, each on
+// its share of every loop, and wait for the others before a step that reads what another one wrote.
+struct worker_team {
+  size_t id;
+  size_t size;
+  std::barrier<>* sync;
+
+  // this thread's share [begin(count), end(count)) of count items
+  size_t begin(size_t count) const {
+    return count * id / size;
   }
-  if (a._data.size() != b._data.size()) {
-    return (a._data.size() > b._data.size()) ^ a._sign;
+
+  size_t end(size_t count) const {
+    return count * (id + 1) / size;
   }
 
-  for (size_t i = a.length(); i > 0; --i) {
-    if (a[i - 1] != b[i - 1]) {
-      return (a[i - 1] > b[i - 1]) ^ a._sign;
+  void wait() const {
+    if (sync != nullptr) {
+      sync->arrive_and_wait();
+    }
+  }
+};
+
+// Arithmetic modulo a prime MOD < 2^31 with a large power of two dividing MOD - 1.
+// Values are kept in Montgomery form, x * 2^32 mod MOD.
+template <uint32_t MOD, uint32_t ROOT>
+struct ntt_prime {
+  static constexpr uint32_t NEG_INV = [] {
+    uint32_t inv = MOD;
+    for (size_t i = 0; i < 4; i++) {
+      inv *= 2 - MOD * inv;
     }
+    return ~inv + 1;
+  }();
+  static constexpr uint32_t R2 = (UINT64_MAX % MOD + 1) % MOD;
+  static constexpr uint32_t MODULUS = MOD;
+
+  static constexpr uint32_t reduce(uint64_t x) {
+    uint32_t m = static_cast<uint32_t>(x) * NEG_INV;
+    auto t = static_cast<uint32_t>((x + static_cast<uint64_t>(m) * MOD) >> 32);
+    return t >= MOD ? t - MOD : t;
   }
 
-  return false;
-}
+  static constexpr uint32_t mul(uint32_t a, uint32_t b) {
+    return reduce(static_cast<uint64_t>(a) * b);
+  }
 
-bool operator<=(const big_integer& a, const big_integer& b) {
-  return !(a > b);
-}
+  static constexpr uint32_t add(uint32_t a, uint32_t b) {
+    return a + b >= MOD ? a + b - MOD : a + b;
+  }
 
-bool operator>=(const big_integer& a, const big_integer& b) {
-  return !(b > a);
-}
+  static constexpr uint32_t sub(uint32_t a, uint32_t b) {
+    return a >= b ? a - b : a + MOD - b;
+  }
 
-bool operator!=(const big_integer& a, const big_integer& b) {
-  return !(a == b);
-}
+  // any 32-bit value into Montgomery form
+  static constexpr uint32_t to_mont(uint32_t a) {
+    return reduce(static_cast<uint64_t>(a) * R2);
+  }
 
-bool operator<(const big_integer& a, const big_integer& b) {
-  return !(a >= b);
-}
+  static constexpr uint32_t pow(uint32_t a, uint64_t power) {
+    uint32_t result = to_mont(1);
+    for (; power > 0; power >>= 1) {
+      if (power & 1) {
+        result = mul(result, a);
+      }
+      a = mul(a, a);
+    }
+    return result;
+  }
 
-std::string to_string(const big_integer& a) {
-  std::string s;
-  big_integer tmp_integer = a;
-  while (tmp_integer != 0 || s.empty()) {
-    big_integer reminder(tmp_integer % INT_MOD);
-    uint32_t reminder_uint = (reminder.length()) ? reminder[0] : 0;
-    tmp_integer /= INT_MOD;
-    std::string str_to_add = std::to_string(reminder_uint);
-    std::reverse(str_to_add.begin(), str_to_add.end());
-    if (tmp_integer != 0) {
-      while (str_to_add.size() < DIGITS_CNT) {
-        str_to_add += '0';
+  // w[half + j] = z^j for j < half, where z is a primitive (2 * half)-th root of unity,
+  // so that every butterfly level reads its twiddle factors contiguously
+  static void roots(uint32_t* w, size_t len, bool inverse, const worker_team& team) {
+    for (size_t half = 1; half < len; half *= 2) {
+      uint32_t z = pow(to_mont(ROOT), (MOD - 1) / (2 * half));
+      if (inverse) {
+        z = pow(z, 2 * half - 1);
+      }
+      size_t begin = team.begin(half);
+      size_t end = team.end(half);
+      if (begin < end) {
+        w[half + begin] = pow(z, begin);
+      }
+      for (size_t j = begin + 1; j < end; j++) {
+        w[half + j] = mul(w[half + j - 1], z);
       }
     }
-    s += str_to_add;
   }
 
-  if (a._sign && !a.eq_zero()) {
-    s.push_back('-');
+  // the transforms of a team split the top levels by twiddle factor and hand out the rest as independent
+  // transforms of blocks, several per thread
+  static size_t team_block(size_t len, const worker_team& team) {
+    return len / std::min(len, std::bit_ceil(team.size) * 8);
   }
-  std::reverse(s.begin(), s.end());
-  return s;
-}
 
-void big_integer::div_uint(const uint32_t& rhs) {
-  uint64_t carry = 0;
-  for (size_t i = length(); i > 0; i--) {
-    uint64_t cur = _data[i - 1] + carry * BASE;
-    _data[i - 1] = static_cast<uint32_t>(cur / rhs);
-    carry = cur % rhs;
+  // decimation in frequency: natural order in, bit-reversed order out
+  static void forward(uint32_t* a, size_t len, const uint32_t* w) {
+    for (size_t half = len / 2; half > 0; half /= 2) {
+      for (size_t i = 0; i < len; i += 2 * half) {
+        for (size_t j = 0; j < half; j++) {
+          uint32_t u = a[i + j];
+          uint32_t v = a[i + j + half];
+          a[i + j] = add(u, v);
+          a[i + j + half] = mul(sub(u, v), w[half + j]);
+        }
+      }
+    }
   }
-  trim();
-}
 
-std::ostream& operator<<(std::ostream& out, const big_integer& a) {
-  return out << to_string(a);
+  // decimation in time: bit-reversed order in, natural order out, not scaled by 1 / len
+  static void backward(uint32_t* a, size_t len, const uint32_t* w) {
+    for (size_t half = 1; half < len; half *= 2) {
+      for (size_t i = 0; i < len; i += 2 * half) {
+        for (size_t j = 0; j < half; j++) {
+          uint32_t u = a[i + j];
+          uint32_t v = mul(a[i + j + half], w[half + j]);
+          a[i + j] = add(u, v);
+          a[i + j + half] = sub(u, v);
+        }
+      }
+    }
+  }
+
+  static void forward(uint32_t* a, size_t len, const uint32_t* w, const worker_team& team) {
+    if (team.size == 1) {
+      forward(a, len, w);
+      return;
+    }
+    size_t block = team_block(len, team);
+    for (size_t half = len / 2; half >= block; half /= 2) {
+      size_t begin = team.begin(half);
+      size_t end = team.end(half);
+      for (size_t i = 0; i < len; i += 2 * half) {
+        for (size_t j = begin; j < end; j++) {
+          uint32_t u = a[i + j];
+          uint32_t v = a[i + j + half];
+          a[i + j] = add(u, v);
+          a[i + j + half] = mul(sub(u, v), w[half + j]);
+        }
+      }
+      team.wait();
+    }
+    for (size_t i = team.id * block; i < len; i += team.size * block) {
+      forward(a + i, block, w);
+    }
+    team.wait();
+  }
+
+  static void backward(uint32_t* a, size_t len, const uint32_t* w, const worker_team& team) {
+    if (team.size == 1) {
+      backward(a, len, w);
+      return;
+    }
+    size_t block = team_block(len, team);
+    for (size_t i = team.id * block; i < len; i += team.size * block) {
+      backward(a + i, block, w);
+    }
+    team.wait();
+    for (size_t half = block; half < len; half *= 2) {
+      size_t begin = team.begin(half);
+      size_t end = team.end(half);
+      for (size_t i = 0; i < len; i += 2 * half) {
+        for (size_t j = begin; j < end; j++) {
+          uint32_t u = a[i + j];
+          uint32_t v = mul(a[i + j + half], w[half + j]);
+          a[i + j] = add(u, v);
+          a[i + j + half] = sub(u, v);
+        }
+      }
+      team.wait();
+    }
+  }
+
+  // c[0..len) = a[0..n) * b[0..m) modulo MOD and x^len - 1, in normal form; tmp and w are len limbs of scratch.
+  // Every thread of the team calls it, it returns once all of them are done.
+  static void convolve(uint32_t* c, const uint32_t* a, size_t n, const uint32_t* b, size_t m, size_t len,
+                       uint32_t* tmp, uint32_t* w, const worker_team& team) {
+    bool square = a == b && n == m;
+    size_t begin = team.begin(len);
+    size_t end = team.end(len);
+    roots(w, len, false, team);
+    std::transform(a + std::min(begin, n), a + std::min(end, n), c + std::min(begin, n), to_mont);
+    std::fill(c + std::max(begin, n), c + std::max(end, n), 0);
+    if (square) {
+      tmp = c;
+    } else {
+      std::transform(b + std::min(begin, m), b + std::min(end, m), tmp + std::min(begin, m), to_mont);
+      std::fill(tmp + std::max(begin, m), tmp + std::max(end, m), 0);
+    }
+    team.wait();
+    forward(c, len, w, team);
+    if (!square) {
+      forward(tmp, len, w, team);
+    }
+    for (size_t i = begin; i < end; i++) {
+      c[i] = mul(c[i], tmp[i]);
+    }
+    roots(w, len, true, team);
+    team.wait();
+    backward(c, len, w, team);
+    // multiplying by 1 / len in normal form also leaves Montgomery form
+    uint32_t inv_len = MOD - (MOD - 1) / len;
+    for (size_t i = begin; i < end; i++) {
+      c[i] = mul(c[i], inv_len);
+    }
+    team.wait();
+  }
+};
+
+using ntt_prime_1 = ntt_prime<167772161, 3>;
+using ntt_prime_2 = ntt_prime<469762049, 3>;
+using ntt_prime_3 = ntt_prime<2013265921, 31>;
+
+constexpr uint64_t pow_mod(uint64_t a, uint64_t power, uint64_t mod) {
+  uint64_t result = 1;
+  for (a %= mod; power > 0; power >>= 1) {
+    if (power & 1) {
+      result = result * a % mod;
+    }
+    a = a * a % mod;
+  }
+  return result;
+}
+
+// the primes multiply to about 2^87, enough for a coefficient sum of 2^22 products of two 32-bit pieces
+constexpr size_t NTT_MAX_TERMS = size_t{1} << 22;
+constexpr size_t NTT_MAX_LENGTH = size_t{1} << 25;
+} // namespace
+
+// the transforms work on 32-bit pieces of the limbs
+static constexpr size_t NTT_PIECES = EXP / 32;
+
+static bool ntt_fits(size_t n, size_t m) {
+  return std::min(n, m) * NTT_PIECES <= NTT_MAX_TERMS && (n + m) * NTT_PIECES <= NTT_MAX_LENGTH;
+}
+
+static std::vector<uint32_t> ntt_pieces(const limb_t* a, size_t n) {
+  std::vector<uint32_t> result(n * NTT_PIECES);
+  for (size_t i = 0; i < result.size(); i++) {
+    result[i] = static_cast<uint32_t>(a[i / NTT_PIECES] >> (32 * (i % NTT_PIECES)));
+  }
+  return result;
+}
+
+static std::atomic<unsigned> multiplication_thread_count{1};
+
+void set_multiplication_threads(unsigned count) {
+  if (count == 0) {
+    count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  multiplication_thread_count.store(count, std::memory_order_relaxed);
+}
+
+unsigned multiplication_threads() {
+  return multiplication_thread_count.load(std::memory_order_relaxed);
+}
+
+// Runs f(team) on up to `size` threads, the calling one included, and returns how many took part: if the system
+// runs out of threads the team is smaller. f must not throw.
+template <class F>
+static size_t run_team(size_t size, const F& f) {
+  if (size == 1) {
+    f(worker_team{0, 1, nullptr});
+    return 1;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(size - 1);
+  std::optional<std::barrier<>> sync;
+  std::latch started(1);
+  size_t team_size = 0;
+  try {
+    for (size_t i = 1; i < size; i++) {
+      threads.emplace_back([&f, &sync, &started, &team_size, i] {
+        started.wait();
+        f(worker_team{i, team_size, &*sync});
+      });
+    }
+  } catch (...) {
+    // a smaller team, as large as the system allows
+  }
+  size = team_size = threads.size() + 1;
+  sync.emplace(static_cast<std::ptrdiff_t>(size));
+  started.count_down();
+  f(worker_team{0, size, &*sync});
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return size;
+}
+
+// Garner's algorithm for the limbs r[begin..end) of a product with the given number of pieces, with the carries
+// propagated inside the range; returns the carry out of it
+static uint64_t ntt_recombine(limb_t* r, size_t begin, size_t end, const uint32_t* c1, const uint32_t* c2,
+                              const uint32_t* c3, size_t pieces) {
+  constexpr uint64_t P1 = ntt_prime_1::MODULUS;
+  constexpr uint64_t P2 = ntt_prime_2::MODULUS;
+  constexpr uint64_t P3 = ntt_prime_3::MODULUS;
+  constexpr uint64_t P12 = P1 * P2;
+  constexpr uint64_t INV_P1 = pow_mod(P1, P2 - 2, P2);
+  constexpr uint64_t INV_P12 = pow_mod(P12, P3 - 2, P3);
+  constexpr uint64_t MASK = UINT32_MAX;
+
+  std::fill(r + begin, r + end, 0);
+  uint64_t carry = 0;
+  for (size_t i = begin * NTT_PIECES; i < std::min(end * NTT_PIECES, pieces); i++) {
+    uint64_t x1 = c1[i];
+    uint64_t x12 = x1 + P1 * ((c2[i] + P2 - x1) * INV_P1 % P2);
+    uint64_t t = (c3[i] + P3 - x12 % P3) * INV_P12 % P3;
+    // x12 + P12 * t + carry, split at the piece boundary
+    uint64_t lo = (x12 & MASK) + (P12 & MASK) * t + (carry & MASK);
+    r[i / NTT_PIECES] |= limb_cast(lo & MASK) << (32 * (i % NTT_PIECES));
+    carry = (x12 >> 32) + (P12 >> 32) * t + (carry >> 32) + (lo >> 32);
+  }
+  return carry;
+}
+
+// r[0..n+m) = a[0..n) * b[0..m): a cyclic convolution of the pieces modulo three primes, recombined with Garner's
+// algorithm while the carries are propagated. Long products are split between multiplication_threads() threads,
+// each gets PARALLEL_MUL_THRESHOLD limbs of the product or more.
+static void ntt_mul(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+  bool square = a == b && n == m;
+  std::vector<uint32_t> pa = ntt_pieces(a, n);
+  std::vector<uint32_t> pb = square ? std::vector<uint32_t>() : ntt_pieces(b, m);
+  const uint32_t* pb_data = square ? pa.data() : pb.data();
+  size_t pn = n * NTT_PIECES;
+  size_t pm = m * NTT_PIECES;
+  size_t len = std::bit_ceil(pn + pm);
+  std::vector<uint32_t> buf(4 * len);
+  uint32_t* c1 = buf.data();
+  uint32_t* c2 = c1 + len;
+  uint32_t* c3 = c2 + len;
+  uint32_t* tmp = c3 + len;
+  std::vector<uint32_t> w(len);
+
+  size_t threads = std::clamp<size_t>((n + m) / PARALLEL_MUL_THRESHOLD, 1, multiplication_threads());
+  std::vector<uint64_t> carries(threads);
+  threads = run_team(threads, [&](const worker_team& team) {
+    ntt_prime_1::convolve(c1, pa.data(), pn, pb_data, pm, len, tmp, w.data(), team);
+    ntt_prime_2::convolve(c2, pa.data(), pn, pb_data, pm, len, tmp, w.data(), team);
+    ntt_prime_3::convolve(c3, pa.data(), pn, pb_data, pm, len, tmp, w.data(), team);
+    carries[team.id] = ntt_recombine(r, team.begin(n + m), team.end(n + m), c1, c2, c3, pn + pm);
+  });
+  // the carry out of every share goes into the limbs above it
+  constexpr size_t CARRY_LIMBS = sizeof(uint64_t) / sizeof(limb_t);
+  for (size_t i = 0; i + 1 < threads; i++) {
+    size_t at = (n + m) * (i + 1) / threads;
+    limb_t carry[CARRY_LIMBS];
+    for (size_t j = 0; j < CARRY_LIMBS; j++) {
+      carry[j] = limb_cast(carries[i] >> (EXP * j));
+    }
+    add_limbs(r + at, r + at, n + m - at, carry, std::min(CARRY_LIMBS, n + m - at));
+  }
+  assert(carries[threads - 1] == 0);
+}
+
+// scratch limbs of mul_balanced for n-limb operands; NTT products allocate their own buffers
+static size_t mul_scratch(size_t n) {
+  if (n >= NTT_THRESHOLD && ntt_fits(n, n)) {
+    return 0;
+  } else if (n >= TOOM4_THRESHOLD) {
+    return toom4_scratch(n);
+  } else if (n >= TOOM3_THRESHOLD) {
+    return toom3_scratch(n);
+  }
+  return karatsuba_scratch(n);
+}
+
+// r[0..2n) = a[0..n) * b[0..n), a == b selects squaring; scratch has mul_scratch(n) limbs
+static void mul_balanced(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t* scratch) {
+  if (n >= NTT_THRESHOLD && ntt_fits(n, n)) {
+    ntt_mul(r, a, n, b, n);
+  } else if (n >= TOOM4_THRESHOLD) {
+    toom4_mul(r, a, b, n, scratch);
+  } else if (n >= TOOM3_THRESHOLD) {
+    toom3_mul(r, a, b, n, scratch);
+  } else if (a == b) {
+    if (n < KARATSUBA_SQR_THRESHOLD) {
+      sqr_basecase(r, a, n);
+    } else {
+      karatsuba_sqr(r, a, n, scratch);
+    }
+  } else if (n < KARATSUBA_THRESHOLD) {
+    mul_basecase(r, a, n, b, n);
+  } else {
+    karatsuba_mul(r, a, b, n, scratch);
+  }
+}
+
+// scratch limbs of mul_limbs for n- and m-limb operands, n >= m
+static size_t mul_limbs_scratch(size_t n, size_t m) {
+  if (m < KARATSUBA_THRESHOLD) {
+    return 0;
+  }
+  if (n == m) {
+    return mul_scratch(n);
+  }
+  if (m >= NTT_THRESHOLD && ntt_fits(n, m)) {
+    return 0;
+  }
+  return 2 * m + std::max(mul_scratch(m), n % m == 0 ? 0 : mul_limbs_scratch(m, n % m));
+}
+
+// r[0..n+m) = a[0..n) * b[0..m), n >= m; r must not alias the operands; scratch has mul_limbs_scratch(n, m) limbs
+static void mul_limbs(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m, limb_t* scratch) {
+  if (m < KARATSUBA_THRESHOLD) {
+    mul_basecase(r, a, n, b, m);
+    return;
+  }
+  if (n == m) {
+    mul_balanced(r, a, b, n, scratch);
+    return;
+  }
+  if (m >= NTT_THRESHOLD && ntt_fits(n, m)) {
+    ntt_mul(r, a, n, b, m);
+    return;
+  }
+  // split the longer operand into m-limb blocks, each block product is balanced
+  limb_t* tmp = scratch;
+  std::fill(r, r + n + m, 0);
+  for (size_t i = 0; i < n; i += m) {
+    size_t len = std::min(m, n - i);
+    if (len == m) {
+      mul_balanced(tmp, a + i, b, m, scratch + 2 * m);
+    } else {
+      mul_limbs(tmp, b, m, a + i, len, scratch + 2 * m);
+    }
+    add_limbs(r + i, r + i, n + m - i, tmp, len + m);
+  }
+}
+
+// r[0..n+m) = a[0..n) * b[0..m), n >= m; r must not alias the operands
+static void mul_limbs(limb_t* r, const limb_t* a, size_t n, const limb_t* b, size_t m) {
+  std::vector<limb_t> scratch(mul_limbs_scratch(n, m));
+  mul_limbs(r, a, n, b, m, scratch.data());
+}
+
+// r[0..2n) = a[0..n)^2; r must not alias a
+static void sqr_limbs(limb_t* r, const limb_t* a, size_t n) {
+  std::vector<limb_t> scratch(mul_scratch(n));
+  mul_balanced(r, a, a, n, scratch.data());
+}
+
+big_integer& big_integer::operator*=(const big_integer& rhs) {
+  big_integer result;
+  result._data.resize(length() + rhs.length());
+  if (this == &rhs || _data == rhs._data) {
+    sqr_limbs(result._data.data(), _data.data(), length());
+  } else if (length() >= rhs.length()) {
+    mul_limbs(result._data.data(), _data.data(), length(), rhs._data.data(), rhs.length());
+  } else {
+    mul_limbs(result._data.data(), rhs._data.data(), rhs.length(), _data.data(), length());
+  }
+  result._sign = _sign ^ rhs._sign;
+  result.trim();
+  swap(*this, result);
+  return *this;
+}
+
+static size_t submul_correct_scratch(size_t l, size_t k) {
+  return l + k + (l >= k ? mul_limbs_scratch(l, k) : mul_limbs_scratch(k, l));
+}
+
+// a[0..n) -= (q_top * BASE^l + q[0..l)) * c[0..k); while a is negative, the quotient is decremented
+// and d[0..n) is added back. scratch has submul_correct_scratch(l, k) limbs.
+static void submul_correct(limb_t* a, size_t n, limb_t* q, size_t l, limb_t& q_top, const limb_t* c,
+                           size_t k, const limb_t* d, limb_t* scratch) {
+  limb_t* prod = scratch;
+  if (l >= k) {
+    mul_limbs(prod, q, l, c, k, scratch + l + k);
+  } else {
+    mul_limbs(prod, c, k, q, l, scratch + l + k);
+  }
+  limb_t borrow = sub_limbs(a, a, n, prod, l + k);
+  if (q_top != 0) {
+    borrow += sub_limbs(a + l, a + l, n - l, c, k);
+  }
+  limb_t one = 1;
+  while (borrow != 0) {
+    q_top -= sub_limbs(q, q, l, &one, 1);
+    borrow -= add_limbs(a, a, n, d, n);
+  }
+}
+
+// Recursive division (Burnikel and Ziegler; MCA, algorithm 1.8), same contract as divrem_basecase, m <= n.
+// scratch limbs of divrem_recursive, the largest of the products it corrects with
+static size_t divrem_recursive_scratch(size_t m, size_t n) {
+  if (m < DIV_BZ_THRESHOLD) {
+    return 0;
+  }
+  if (m < n) {
+    return std::max(divrem_recursive_scratch(m, m), submul_correct_scratch(m, n - m));
+  }
+  size_t k = m / 2;
+  return std::max({divrem_recursive_scratch(m - k, n - k), submul_correct_scratch(m - k, k),
+                   divrem_recursive_scratch(k, n - k), submul_correct_scratch(k, k)});
+}
+
+// Each half of the quotient is a recursive division by the top half of d followed by a multiplication
+// by its bottom half, so the cost is O(M(n) log n). scratch has divrem_recursive_scratch(m, n) limbs,
+// it is shared by all levels.
+static limb_t divrem_recursive(limb_t* q, limb_t* a, size_t m, const limb_t* d, size_t n, limb_t* scratch) {
+  if (m < DIV_BZ_THRESHOLD) {
+    return divrem_basecase(q, a, m, d, n);
+  }
+  if (m < n) {
+    // the quotient is estimated from the top m limbs of d and corrected with the rest
+    size_t k = n - m;
+    limb_t q_top = divrem_recursive(q, a + k, m, d + k, m, scratch);
+    submul_correct(a, n, q, m, q_top, d, k, d, scratch);
+    return q_top;
+  }
+  size_t k = m / 2;
+  limb_t q1_top = divrem_recursive(q + k, a + 2 * k, m - k, d + k, n - k, scratch);
+  submul_correct(a + k, n, q + k, m - k, q1_top, d, k, d, scratch);
+  limb_t q0_top = divrem_recursive(q, a + k, k, d + k, n - k, scratch);
+  submul_correct(a, n, q, k, q0_top, d, k, d, scratch);
+  return q1_top + add_limbs(q + k, q + k, m - k, &q0_top, 1);
+}
+
+static size_t divrem_scratch(size_t m, size_t n) {
+  if (n < DIV_BZ_THRESHOLD) {
+    return 0;
+  }
+  return std::max(divrem_recursive_scratch(std::min(m, n), n), divrem_recursive_scratch(m % n, n));
+}
+
+// Same contract as divrem_basecase, for any m; scratch has divrem_scratch(m, n) limbs
+static limb_t divrem_limbs(limb_t* q, limb_t* a, size_t m, const limb_t* d, size_t n, limb_t* scratch) {
+  if (n < DIV_BZ_THRESHOLD) {
+    return divrem_basecase(q, a, m, d, n);
+  }
+  // a long quotient is produced in n-limb blocks, each block is a 2n by n division
+  limb_t q_top = 0;
+  for (size_t j = m; j > 0;) {
+    size_t len = std::min(j, n);
+    j -= len;
+    limb_t top = divrem_recursive(q + j, a + j, len, d, n, scratch);
+    if (j + len == m) {
+      q_top = top;
+    }
+  }
+  return q_top;
+}
+
+static void trim_limbs(limb_vector& a) {
+  while (!a.empty() && a.back() == 0) {
+    a.pop_back();
+  }
+}
+
+// q = r / d and r = r % d in place, for trimmed r and d, r.size() >= d.size() >= 2; q and r are trimmed.
+// Besides q, the only allocation is one scratch block for the normalized divisor and the recursive products
+// (NTT-sized products still allocate their own buffers).
+static void divmod_limbs(limb_vector& q, limb_vector& r, const limb_vector& d) {
+  size_t n = d.size();
+  size_t m = r.size() + 1 - n;
+  size_t shift = std::countl_zero(d.back());
+  std::vector<limb_t> scratch((shift != 0 ? n : 0) + divrem_scratch(m, n));
+  const limb_t* divisor = d.data();
+  r.push_back(0);
+  if (shift != 0) {
+    lshift_limbs(scratch.data(), d.data(), n, shift);
+    divisor = scratch.data();
+    r.back() = lshift_limbs(r.data(), r.data(), r.size() - 1, shift);
+  }
+  q.resize(m + 1);
+  q.back() = divrem_limbs(q.data(), r.data(), m, divisor, n, scratch.data() + (shift != 0 ? n : 0));
+  r.resize(n);
+  if (shift != 0) {
+    rshift_limbs(r.data(), r.data(), n, shift);
+  }
+  trim_limbs(q);
+  trim_limbs(r);
+}
+
+template <bool return_remainder>
+big_integer& big_integer::abstract_division(const big_integer& rhs) {
+  if (rhs == 0) {
+    throw std::invalid_argument("Cannot divide by zero");
+  }
+  if (rhs.length() == 1) {
+    limb_t remainder = div_uint(rhs[0]);
+    if (return_remainder) {
+      _data.assign(1, remainder);
+      trim();
+    } else {
+      _sign ^= rhs._sign;
+    }
+    return *this;
+  }
+  if (!abs_great_or_eq(rhs)) {
+    return return_remainder ? *this : *this = 0;
+  }
+  if (this == &rhs) {
+    return *this = return_remainder ? 0 : 1;
+  }
+  limb_vector q;
+  divmod_limbs(q, _data, rhs._data);
+  if (!return_remainder) {
+    std::swap(_data, q);
+    _sign ^= rhs._sign;
+  }
+  return *this;
+}
+
+big_integer& big_integer::operator/=(const big_integer& rhs) {
+  return abstract_division<false>(rhs);
+}
+
+big_integer& big_integer::operator%=(const big_integer& rhs) {
+  return abstract_division<true>(rhs);
+}
+
+// r[0..n) = t[0..2n) / BASE^n mod m[0..n) for an odd m and t < m * BASE^n (Montgomery reduction); t is clobbered
+static void redc_limbs(limb_t* r, limb_t* t, const limb_t* m, size_t n, limb_t neg_inv) {
+  limb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    limb_t hi = addmul_limbs(t + i, m, n, t[i] * neg_inv);
+    dlimb_t cur = dlimb_cast(t[i + n]) + hi + carry;
+    t[i + n] = limb_cast(cur);
+    carry = limb_cast(cur >> EXP);
+  }
+  if (carry != 0 || cmp_limbs(t + n, m, n) >= 0) {
+    sub_limbs(r, t + n, n, m, n);
+  } else {
+    std::copy(t + n, t + 2 * n, r);
+  }
+}
+
+// r[0..n) = a[0..n) * b[0..n) / BASE^n mod m[0..n); t is 2n limbs of scratch, r may alias a or b
+static void mont_mul_limbs(limb_t* r, const limb_t* a, const limb_t* b, const limb_t* m, size_t n, limb_t neg_inv,
+                           limb_t* t) {
+  if (a == b) {
+    sqr_limbs(t, a, n);
+  } else {
+    mul_limbs(t, a, n, b, n);
+  }
+  redc_limbs(r, t, m, n, neg_inv);
+}
+
+// exponent sizes, in bits, above which the sliding window grows by one bit
+static constexpr size_t WINDOW_LIMITS[] = {7, 23, 79, 239, 671};
+
+// base^exp[0..n) by left-to-right sliding windows over the exponent bits, exp[n - 1] != 0;
+// mul(x, y) returns the product in the target ring and is passed equal arguments for squarings
+template <typename T, typename Mul>
+static T window_pow(const T& base, const limb_t* exp, size_t n, Mul mul) {
+  size_t bits = n * EXP - std::countl_zero(exp[n - 1]);
+  size_t k = 1;
+  for (size_t limit : WINDOW_LIMITS) {
+    k += bits > limit;
+  }
+  auto bit = [exp](size_t i) { return (exp[i / EXP] >> (i % EXP)) & 1; };
+  // odd[i] = base^(2i + 1)
+  std::vector<T> odd(size_t{1} << (k - 1), base);
+  if (odd.size() > 1) {
+    T square = mul(base, base);
+    for (size_t i = 1; i < odd.size(); i++) {
+      odd[i] = mul(odd[i - 1], square);
+    }
+  }
+  T result;
+  bool started = false;
+  for (size_t i = bits; i > 0;) {
+    if (bit(i - 1) == 0) {
+      result = mul(result, result);
+      i--;
+      continue;
+    }
+    // the longest window [j, i) of at most k bits that ends with a set bit
+    size_t j = i > k ? i - k : 0;
+    while (bit(j) == 0) {
+      j++;
+    }
+    size_t value = 0;
+    for (size_t t = i; t > j; t--) {
+      value = value * 2 + bit(t - 1);
+      if (started) {
+        result = mul(result, result);
+      }
+    }
+    result = started ? mul(result, odd[value / 2]) : odd[value / 2];
+    started = true;
+    i = j;
+  }
+  return result;
+}
+
+montgomery_context::montgomery_context(const big_integer& mod) : _mod(mod) {
+  if (_mod.eq_zero() || (_mod[0] & 1) == 0) {
+    throw std::invalid_argument("Montgomery modulus must be odd");
+  }
+  _mod._sign = false;
+  size_t n = _mod.length();
+  limb_t inv = _mod[0];
+  for (size_t bits = 3; bits < EXP; bits *= 2) {
+    inv *= 2 - _mod[0] * inv;
+  }
+  _neg_inv = limb_t{0} - inv;
+  big_integer r2 = 1;
+  r2 <<= static_cast<int>(2 * n * EXP);
+  r2 %= _mod;
+  _r2 = std::move(r2._data);
+  _r2.resize(n);
+}
+
+const big_integer& montgomery_context::modulus() const {
+  return _mod;
+}
+
+big_integer montgomery_context::pow(const big_integer& base, const big_integer& exp) const {
+  if (exp._sign && !exp.eq_zero()) {
+    throw std::invalid_argument("Exponent must be non-negative");
+  }
+  if (exp.eq_zero()) {
+    return 1 % _mod;
+  }
+  size_t n = _mod.length();
+  const limb_t* m = _mod._data.data();
+  limb_vector t(2 * n);
+  auto mul = [&](const limb_vector& x, const limb_vector& y) {
+    limb_vector r(n);
+    mont_mul_limbs(r.data(), x.data(), y.data(), m, n, _neg_inv, t.data());
+    return r;
+  };
+
+  big_integer x = base % _mod;
+  if (x._sign && !x.eq_zero()) {
+    x += _mod;
+  }
+  x._data.resize(n);
+  limb_vector result = window_pow(mul(x._data, _r2), exp._data.data(), exp.length(), mul);
+
+  // leaving Montgomery form is a reduction of the zero-extended value
+  std::copy(result.begin(), result.end(), t.begin());
+  std::fill(t.begin() + n, t.end(), 0);
+  big_integer r;
+  r._data.resize(n);
+  redc_limbs(r._data.data(), t.data(), m, n, _neg_inv);
+  r.trim();
+  return r;
+}
+
+// t[0..n) = t[0..2n) mod m[0..n) for mu[0..k) = floor(BASE^2n / m), k > n (Barrett reduction; HAC, algorithm 14.42).
+// The quotient estimate from the top limbs of t is at most three below the true one, scratch is barrett_scratch(n, k)
+// limbs. Below BARRETT_THRESHOLD only the needed parts of both products are computed.
+static size_t barrett_scratch(size_t n, size_t k) {
+  return 3 * n + k + 2;
+}
+
+static void barrett_limbs(limb_t* t, const limb_t* m, size_t n, const limb_t* mu, size_t k, limb_t* scratch) {
+  limb_t* q = scratch;
+  limb_t* p = q + n + 1 + k;
+  // the estimate is q[n + 1..n + 1 + k), it is below BASE^(n+1)
+  const limb_t* q3 = q + n + 1;
+  if (n < BARRETT_THRESHOLD) {
+    // the columns below n - 1 can carry at most one into the estimate
+    std::fill(q, q + n + 1 + k, 0);
+    for (size_t i = 0; i <= n; i++) {
+      size_t j = i + 1 < n ? n - 1 - i : 0;
+      q[i + k] = addmul_limbs(q + i + j, mu + j, k - j, t[n - 1 + i]);
+    }
+    p[n] = mul_1_limbs(p, m, n, q3[0]);
+    for (size_t i = 1; i <= n; i++) {
+      addmul_limbs(p + i, m, n + 1 - i, q3[i]);
+    }
+  } else {
+    if (n + 1 >= k) {
+      mul_limbs(q, t + n - 1, n + 1, mu, k);
+    } else {
+      mul_limbs(q, mu, k, t + n - 1, n + 1);
+    }
+    mul_limbs(p, q3, n + 1, m, n);
+  }
+  // only the low n + 1 limbs of the remainder and of the product are needed
+  sub_limbs(t, t, n + 1, p, n + 1);
+  while (t[n] != 0 || cmp_limbs(t, m, n) >= 0) {
+    t[n] -= sub_limbs(t, t, n, m, n);
+  }
+}
+
+big_integer_modulus::big_integer_modulus(const big_integer& mod) : _mod(mod) {
+  if (_mod.eq_zero()) {
+    throw std::invalid_argument("Cannot divide by zero");
+  }
+  _mod._sign = false;
+  big_integer inv = 1;
+  inv <<= static_cast<int>(2 * _mod.length() * EXP);
+  inv /= _mod;
+  _inv = std::move(inv._data);
+}
+
+const big_integer& big_integer_modulus::modulus() const {
+  return _mod;
+}
+
+big_integer big_integer_modulus::reduce(const big_integer& x) const {
+  size_t n = _mod.length();
+  size_t len = x.length();
+  if (len < n) {
+    return x;
+  }
+  // the top 2n limbs first, then every n limbs below are appended to the remainder and reduced again
+  limb_vector t(2 * n);
+  limb_vector scratch(barrett_scratch(n, _inv.size()));
+  size_t j = len - std::min(len, 2 * n);
+  std::copy(x._data.begin() + j, x._data.end(), t.begin());
+  barrett_limbs(t.data(), _mod._data.data(), n, _inv.data(), _inv.size(), scratch.data());
+  while (j > 0) {
+    size_t take = std::min(j, n);
+    j -= take;
+    std::copy_backward(t.begin(), t.begin() + n, t.begin() + n + take);
+    std::fill(t.begin() + n + take, t.end(), 0);
+    std::copy(x._data.begin() + j, x._data.begin() + j + take, t.begin());
+    barrett_limbs(t.data(), _mod._data.data(), n, _inv.data(), _inv.size(), scratch.data());
+  }
+  big_integer r;
+  r._data.assign(t.begin(), t.begin() + n);
+  r._sign = x._sign;
+  r.trim();
+  return r;
+}
+
+big_integer pow_mod(const big_integer& base, const big_integer& exp, const big_integer& mod) {
+  if (mod.eq_zero()) {
+    throw std::invalid_argument("Cannot divide by zero");
+  }
+  if ((mod[0] & 1) != 0) {
+    return montgomery_context(mod).pow(base, exp);
+  }
+  if (exp._sign && !exp.eq_zero()) {
+    throw std::invalid_argument("Exponent must be non-negative");
+  }
+  big_integer_modulus m(mod);
+  big_integer x = m.reduce(base);
+  if (x._sign && !x.eq_zero()) {
+    x += m.modulus();
+  }
+  if (exp.eq_zero()) {
+    return m.reduce(1);
+  }
+  return window_pow(x, exp._data.data(), exp.length(),
+                    [&m](const big_integer& a, const big_integer& b) { return m.reduce(a * b); });
+}
+
+namespace {
+// A matrix with non-negative entries and determinant 1, or -1 if negative, that relates a pair to its reduction:
+// (a, b) = m (a', b'), so a' = m11 a - m01 b and b' = m00 b - m10 a up to the sign of the determinant.
+template <typename T>
+struct gcd_matrix {
+  T m[2][2];
+  bool negative;
+};
+
+using limb_matrix = gcd_matrix<limb_t>;
+using vector_matrix = gcd_matrix<limb_vector>;
+} // namespace
+
+static int cmp_vectors(const limb_vector& a, const limb_vector& b) {
+  if (a.size() != b.size()) {
+    return a.size() < b.size() ? -1 : 1;
+  }
+  return cmp_limbs(a.data(), b.data(), a.size());
+}
+
+static limb_vector mul_vectors(const limb_vector& a, const limb_vector& b) {
+  if (a.empty() || b.empty()) {
+    return {};
+  }
+  limb_vector r(a.size() + b.size());
+  if (a.size() >= b.size()) {
+    mul_limbs(r.data(), a.data(), a.size(), b.data(), b.size());
+  } else {
+    mul_limbs(r.data(), b.data(), b.size(), a.data(), a.size());
+  }
+  trim_limbs(r);
+  return r;
+}
+
+// a += b
+static void add_vectors(limb_vector& a, const limb_vector& b) {
+  a.resize(std::max(a.size(), b.size()) + 1);
+  add_limbs(a.data(), a.data(), a.size(), b.data(), b.size());
+  trim_limbs(a);
+}
+
+// a -= b, a >= b
+static void sub_vectors(limb_vector& a, const limb_vector& b) {
+  sub_limbs(a.data(), a.data(), a.size(), b.data(), b.size());
+  trim_limbs(a);
+}
+
+// x * p + y * q
+static limb_vector lincomb_vectors(const limb_vector& x, limb_t p, const limb_vector& y, limb_t q) {
+  limb_vector r(std::max(x.size(), y.size()) + 1);
+  r[x.size()] = mul_1_limbs(r.data(), x.data(), x.size(), p);
+  limb_t carry = addmul_limbs(r.data(), y.data(), y.size(), q);
+  add_limbs(r.data() + y.size(), r.data() + y.size(), r.size() - y.size(), &carry, 1);
+  trim_limbs(r);
+  return r;
+}
+
+// q = a / b, r = a % b for trimmed a >= b > 0
+static void divmod_vectors(limb_vector& q, limb_vector& r, const limb_vector& a, const limb_vector& b) {
+  if (b.size() >= 2) {
+    r = a;
+    divmod_limbs(q, r, b);
+    return;
+  }
+  q.resize(a.size());
+  r.assign(1, divrem_1_limbs(q.data(), a.data(), a.size(), b[0]));
+  trim_limbs(q);
+  trim_limbs(r);
+}
+
+// The leading quotients of the remainder sequence of a >= b that follow from their top EXP - 1 bits alone (Lehmer,
+// with Collins' condition; see also CPython's _PyLong_GCD). The entries stay below 2^(EXP/2), no quotient is
+// certain if steps is 0. b must have at least two limbs.
+static limb_matrix lehmer_matrix(const limb_vector& a, const limb_vector& b, size_t& steps) {
+  size_t n = a.size();
+  size_t shift = EXP + 1 - std::countl_zero(a[n - 1]);
+  dlimb_t a_top = (dlimb_cast(a[n - 1]) << EXP) | a[n - 2];
+  dlimb_t b_top = (dlimb_cast(b.size() == n ? b[n - 1] : 0) << EXP) | (b.size() + 1 >= n ? b[n - 2] : 0);
+  limb_t x = limb_cast(a_top >> shift);
+  limb_t y = limb_cast(b_top >> shift);
+  // (x, y) = (u00 x0 - u01 y0, u11 y0 - u10 x0) up to signs
+  limb_t u00 = 1;
+  limb_t u01 = 0;
+  limb_t u10 = 0;
+  limb_t u11 = 1;
+  steps = 0;
+  while (y != u10) {
+    limb_t q = (x + (u00 - 1)) / (y - u10);
+    dlimb_t s = u01 + dlimb_cast(q) * u11;
+    if (dlimb_cast(q) * y + s > x) {
+      break;
+    }
+    limb_t t = x - q * y;
+    x = y;
+    y = t;
+    t = u00 + q * u10;
+    u00 = u11;
+    u01 = u10;
+    u10 = limb_cast(s);
+    u11 = t;
+    steps++;
+  }
+  if (steps % 2 == 0) {
+    return {{{u11, u01}, {u10, u00}}, false};
+  }
+  return {{{u10, u00}, {u11, u01}}, true};
+}
+
+// r[0..n) = x[0..n) * p - y[0..n) * q for a result known to be in [0, BASE^n)
+static void lincomb_limbs(limb_t* r, const limb_t* x, limb_t p, const limb_t* y, limb_t q, size_t n) {
+  mul_1_limbs(r, x, n, p);
+  submul_limbs(r, y, n, q);
+}
+
+// (a, b) = m^-1 (a, b) for a matrix of single limbs; t0 and t1 are scratch
+static void reduce_pair(limb_vector& a, limb_vector& b, const limb_matrix& m, limb_vector& t0, limb_vector& t1) {
+  size_t n = a.size();
+  b.resize(n);
+  t0.resize(n);
+  t1.resize(n);
+  if (m.negative) {
+    lincomb_limbs(t0.data(), b.data(), m.m[0][1], a.data(), m.m[1][1], n);
+    lincomb_limbs(t1.data(), a.data(), m.m[1][0], b.data(), m.m[0][0], n);
+  } else {
+    lincomb_limbs(t0.data(), a.data(), m.m[1][1], b.data(), m.m[0][1], n);
+    lincomb_limbs(t1.data(), b.data(), m.m[0][0], a.data(), m.m[1][0], n);
+  }
+  std::swap(a, t0);
+  std::swap(b, t1);
+  trim_limbs(a);
+  trim_limbs(b);
+}
+
+// (a, b) = m^-1 (a, b)
+static void reduce_pair(limb_vector& a, limb_vector& b, const vector_matrix& m) {
+  limb_vector x = mul_vectors(m.m[1][1], a);
+  limb_vector y = mul_vectors(m.m[0][1], b);
+  limb_vector z = mul_vectors(m.m[0][0], b);
+  limb_vector w = mul_vectors(m.m[1][0], a);
+  if (m.negative) {
+    std::swap(x, y);
+    std::swap(z, w);
+  }
+  sub_vectors(x, y);
+  sub_vectors(z, w);
+  a = std::move(x);
+  b = std::move(z);
+}
+
+static vector_matrix identity_matrix() {
+  return {{{{1}, {}}, {{}, {1}}}, false};
+}
+
+static bool is_identity(const vector_matrix& m) {
+  return !m.negative && m.m[0][1].empty() && m.m[1][0].empty();
+}
+
+// m = m * r
+template <typename T>
+static void mul_matrix(vector_matrix& m, const gcd_matrix<T>& r) {
+  for (auto& row : m.m) {
+    if constexpr (std::is_same_v<T, limb_t>) {
+      limb_vector r0 = lincomb_vectors(row[0], r.m[0][0], row[1], r.m[1][0]);
+      row[1] = lincomb_vectors(row[0], r.m[0][1], row[1], r.m[1][1]);
+      row[0] = std::move(r0);
+    } else {
+      limb_vector r0 = mul_vectors(row[0], r.m[0][0]);
+      add_vectors(r0, mul_vectors(row[1], r.m[1][0]));
+      limb_vector r1 = mul_vectors(row[0], r.m[0][1]);
+      add_vectors(r1, mul_vectors(row[1], r.m[1][1]));
+      row[0] = std::move(r0);
+      row[1] = std::move(r1);
+    }
+  }
+  m.negative ^= r.negative;
+}
+
+// the step (a, b) -> (b, a mod b) as a matrix
+static vector_matrix quotient_matrix(limb_vector q) {
+  return {{{std::move(q), {1}}, {{1}, {}}}, true};
+}
+
+// keeps a >= b by swapping the pair and the columns of m
+static void order_pair(limb_vector& a, limb_vector& b, vector_matrix& m) {
+  if (cmp_vectors(a, b) < 0) {
+    std::swap(a, b);
+    std::swap(m.m[0][0], m.m[0][1]);
+    std::swap(m.m[1][0], m.m[1][1]);
+    m.negative = !m.negative;
+  }
+}
+
+// Whether m also reduces every pair that has a and b as its top limbs (Möller, "On Schönhage's algorithm and
+// subquadratic integer gcd computation"): the low limbs change a' and b' by less than the column of m that they
+// are multiplied by, so the reduction stays non-negative and valid for the next level.
+static bool reduces_extensions(const limb_vector& a, const limb_vector& b, const vector_matrix& m) {
+  const limb_vector& bound_a = m.negative ? m.m[1][1] : m.m[0][1];
+  const limb_vector& bound_b = m.negative ? m.m[0][0] : m.m[1][0];
+  return cmp_vectors(a, bound_a) >= 0 && cmp_vectors(b, bound_b) >= 0;
+}
+
+// Half-gcd: reduces trimmed a >= b by a matrix m, (a, b) = m (a', b'), until b' has little more than half the limbs
+// of a. Large operands take the reductions of their top halves recursively, with a division step in between.
+static vector_matrix hgcd(limb_vector& a, limb_vector& b) {
+  size_t n = a.size();
+  size_t s = n / 2 + 1;
+  vector_matrix m = identity_matrix();
+  if (b.size() <= s) {
+    return m;
+  }
+  if (n >= HGCD_THRESHOLD) {
+    size_t p = n / 2;
+    limb_vector a1(a.begin() + p, a.end());
+    limb_vector b1(b.begin() + p, b.end());
+    vector_matrix m1 = hgcd(a1, b1);
+    if (!is_identity(m1)) {
+      reduce_pair(a, b, m1);
+      m = std::move(m1);
+      order_pair(a, b, m);
+    }
+  }
+  limb_vector a0 = a;
+  limb_vector b0 = b;
+  vector_matrix m0 = m;
+  if (n >= HGCD_THRESHOLD && b.size() > s) {
+    limb_vector q;
+    limb_vector r;
+    divmod_vectors(q, r, a, b);
+    if (r.size() > s) {
+      a = std::exchange(b, std::move(r));
+      mul_matrix(m, quotient_matrix(std::move(q)));
+      // the top 2 (a.size() - s) limbs reduce to about a.size() - s limbs, leaving b at about s limbs
+      size_t p = 2 * s - a.size();
+      if (b.size() > p + 2) {
+        limb_vector a2(a.begin() + p, a.end());
+        limb_vector b2(b.begin() + p, b.end());
+        vector_matrix m2 = hgcd(a2, b2);
+        if (!is_identity(m2)) {
+          reduce_pair(a, b, m2);
+          mul_matrix(m, m2);
+          order_pair(a, b, m);
+        }
+      }
+    }
+  }
+  limb_vector t0;
+  limb_vector t1;
+  while (b.size() >= s + 2) {
+    size_t steps;
+    limb_matrix lm = lehmer_matrix(a, b, steps);
+    if (steps != 0) {
+      reduce_pair(a, b, lm, t0, t1);
+      mul_matrix(m, lm);
+      continue;
+    }
+    limb_vector q;
+    limb_vector r;
+    divmod_vectors(q, r, a, b);
+    if (r.size() <= s) {
+      break;
+    }
+    a = std::exchange(b, std::move(r));
+    mul_matrix(m, quotient_matrix(std::move(q)));
+  }
+  if (!reduces_extensions(a, b, m)) {
+    a = std::move(a0);
+    b = std::move(b0);
+    m = std::move(m0);
+  }
+  return m;
+}
+
+// Reduces trimmed a >= b to (gcd, 0). If total is given, it is multiplied by every reduction matrix; its first row
+// may be left empty when only the second one is needed.
+static void gcd_vectors(limb_vector& a, limb_vector& b, vector_matrix* total) {
+  limb_vector t0;
+  limb_vector t1;
+  while (!b.empty()) {
+    if (a.size() >= HGCD_THRESHOLD) {
+      vector_matrix m = hgcd(a, b);
+      if (!is_identity(m)) {
+        if (total != nullptr) {
+          mul_matrix(*total, m);
+        }
+        continue;
+      }
+    } else if (b.size() >= 2) {
+      size_t steps;
+      limb_matrix lm = lehmer_matrix(a, b, steps);
+      if (steps != 0) {
+        reduce_pair(a, b, lm, t0, t1);
+        if (total != nullptr) {
+          mul_matrix(*total, lm);
+        }
+        continue;
+      }
+    }
+    limb_vector q;
+    limb_vector r;
+    divmod_vectors(q, r, a, b);
+    a = std::exchange(b, std::move(r));
+    if (total != nullptr) {
+      mul_matrix(*total, quotient_matrix(std::move(q)));
+    }
+  }
+}
+
+big_integer gcd(const big_integer& a, const big_integer& b) {
+  big_integer r;
+  r._data = a._data;
+  limb_vector c = b._data;
+  if (cmp_vectors(r._data, c) < 0) {
+    std::swap(r._data, c);
+  }
+  gcd_vectors(r._data, c, nullptr);
+  return r;
+}
+
+big_integer extended_gcd(const big_integer& a, const big_integer& b, big_integer& x, big_integer& y) {
+  big_integer g;
+  g._data = a._data;
+  limb_vector c = b._data;
+  bool swapped = cmp_vectors(g._data, c) < 0;
+  if (swapped) {
+    std::swap(g._data, c);
+  }
+  // (|a|, |b|) = m (g, 0), only m11 is needed: g = m11 max(|a|, |b|) - m01 min(|a|, |b|) up to the sign of det m
+  vector_matrix m = {{{{}, {}}, {{}, {1}}}, false};
+  gcd_vectors(g._data, c, &m);
+  if (a.eq_zero() || b.eq_zero()) {
+    x = a.eq_zero() ? 0 : a._sign ? -1 : 1;
+    y = !a.eq_zero() ? 0 : b._sign ? -1 : 1;
+    return g;
+  }
+  big_integer coefficient;
+  coefficient._data = std::move(m.m[1][1]);
+  coefficient._sign = m.negative && !coefficient.eq_zero();
+  if (swapped) {
+    y = b._sign ? -coefficient : coefficient;
+    x = (g - b * y) / a;
+  } else {
+    x = a._sign ? -coefficient : coefficient;
+  }
+  // the smallest x modulo b / g, then y follows
+  big_integer period = b / g;
+  period._sign = false;
+  x %= period;
+  if (x * 2 > period) {
+    x -= period;
+  } else if (x * 2 <= -period) {
+    x += period;
+  }
+  y = (g - a * x) / b;
+  return g;
+}
+
+big_integer mod_inverse(const big_integer& a, const big_integer& m) {
+  if (m == 0) {
+    throw std::invalid_argument("Cannot divide by zero");
+  }
+  big_integer x;
+  big_integer y;
+  if (extended_gcd(a, m, x, y) != 1) {
+    throw std::invalid_argument("Value is not invertible");
+  }
+  big_integer period = m < 0 ? -m : m;
+  x %= period;
+  if (x < 0) {
+    x += period;
+  }
+  return x;
+}
+
+static big_integer pow_ui(big_integer x, unsigned n) {
+  big_integer result = 1;
+  while (true) {
+    if (n & 1) {
+      result *= x;
+    }
+    n >>= 1;
+    if (n == 0) {
+      return result;
+    }
+    x *= x;
+  }
+}
+
+// floor(a^(1/n)) for a positive a of the given bit length and n < bits
+static big_integer root_positive(const big_integer& a, unsigned n, size_t bits) {
+  size_t root_bits = (bits + n - 1) / n; // the root is below 2^root_bits
+  size_t guard = 2 + std::bit_width(n);
+  if (root_bits <= guard + 1) {
+    big_integer x = 0;
+    for (size_t i = root_bits; i > 0; --i) {
+      big_integer y = x + (big_integer(1) << static_cast<int>(i - 1));
+      if (pow_ui(y, n) <= a) {
+        x = std::move(y);
+      }
+    }
+    return x;
+  }
+  // the root of the top bits gives x > root(a) off by less than 2^k, one Newton step from it is off by O(1)
+  size_t k = (root_bits - guard) / 2;
+  big_integer x = (root_positive(a >> static_cast<int>(n * k), n, bits - n * k) + 1) << static_cast<int>(k);
+  while (true) {
+    big_integer p = pow_ui(x, n - 1);
+    if (p * x <= a) {
+      return x;
+    }
+    x = (big_integer(n - 1) * x + a / p) / big_integer(n);
+  }
+}
+
+big_integer iroot(const big_integer& a, unsigned n) {
+  if (n == 0) {
+    throw std::invalid_argument("Root of degree zero");
+  }
+  if (a._sign && n % 2 == 0) {
+    throw std::invalid_argument("Even root of a negative value");
+  }
+  size_t bits = a.eq_zero() ? 0 : a.length() * EXP - std::countl_zero(a._data.back());
+  if (n == 1 || bits <= 1) {
+    return a;
+  }
+  big_integer result = 1;
+  if (n < bits) {
+    big_integer abs = a;
+    abs._sign = false;
+    result = root_positive(abs, n, bits);
+  }
+  result._sign = a._sign;
+  return result;
+}
+
+big_integer isqrt(const big_integer& a) {
+  return iroot(a, 2);
+}
+
+// primes up to n, by a sieve over the odd numbers
+static std::vector<limb_t> primes_up_to(unsigned n) {
+  std::vector<limb_t> primes;
+  if (n < 2) {
+    return primes;
+  }
+  primes.push_back(2);
+  std::vector<bool> composite(n / 2 + 1);
+  for (size_t i = 1; 2 * i + 1 <= n; i++) {
+    if (composite[i]) {
+      continue;
+    }
+    size_t p = 2 * i + 1;
+    primes.push_back(limb_cast(p));
+    for (size_t j = p * p / 2; j < composite.size(); j += p) {
+      composite[j] = true;
+    }
+  }
+  return primes;
+}
+
+// Merges runs of consecutive factors into single limbs, so that the tree starts from full-width leaves
+static std::vector<limb_t> pack_factors(const std::vector<limb_t>& factors) {
+  std::vector<limb_t> packed;
+  limb_t cur = 1;
+  for (limb_t f : factors) {
+    dlimb_t product = dlimb_cast(cur) * f;
+    if ((product >> EXP) != 0) {
+      packed.push_back(cur);
+      cur = f;
+    } else {
+      cur = limb_cast(product);
+    }
+  }
+  packed.push_back(cur);
+  return packed;
+}
+
+// f[0] * ... * f[n - 1], n > 0, split in halves so that both operands of every multiplication have about the same
+// length and the top levels run at the subquadratic sizes
+static limb_vector product_tree(const limb_t* f, size_t n) {
+  if (n <= PRODUCT_TREE_LEAF) {
+    limb_vector r{f[0]};
+    for (size_t i = 1; i < n; i++) {
+      limb_t carry = mul_1_limbs(r.data(), r.data(), r.size(), f[i]);
+      if (carry != 0) {
+        r.push_back(carry);
+      }
+    }
+    return r;
+  }
+  return mul_vectors(product_tree(f, n / 2), product_tree(f + n / 2, n - n / 2));
+}
+
+static limb_vector product_tree(const std::vector<limb_t>& factors) {
+  std::vector<limb_t> packed = pack_factors(factors);
+  return product_tree(packed.data(), packed.size());
+}
+
+// The odd part of the swing factorial n! / (n/2)!^2: an odd prime p enters it with the exponent
+// sum of floor(n / p^i) mod 2 over i >= 1.
+static limb_vector odd_swing(unsigned n, const std::vector<limb_t>& primes) {
+  std::vector<limb_t> factors;
+  for (size_t i = 1; i < primes.size() && primes[i] <= n; i++) {
+    limb_t p = primes[i];
+    for (unsigned q = n / p; q != 0; q /= p) {
+      if (q % 2 != 0) {
+        factors.push_back(p);
+      }
+    }
+  }
+  return product_tree(factors);
+}
+
+// The odd part of n!: odd(n!) = odd((n/2)!)^2 * odd_swing(n).
+static limb_vector odd_factorial(unsigned n, const std::vector<limb_t>& primes) {
+  if (n < FACTORIAL_SWING_THRESHOLD) {
+    std::vector<limb_t> factors;
+    for (unsigned i = 3; i <= n; i += 2) {
+      factors.push_back(i);
+    }
+    for (unsigned m = n / 2; m >= 3; m /= 2) {
+      for (unsigned i = 3; i <= m; i += 2) {
+        factors.push_back(i);
+      }
+    }
+    return product_tree(factors);
+  }
+  limb_vector half = odd_factorial(n / 2, primes);
+  return mul_vectors(mul_vectors(half, half), odd_swing(n, primes));
+}
+
+big_integer factorial(unsigned n) {
+  big_integer result;
+  result._data = odd_factorial(n, primes_up_to(n < FACTORIAL_SWING_THRESHOLD ? 0 : n));
+  // n! has n - popcount(n) factors of two
+  result <<= static_cast<int>(n - std::popcount(n));
+  return result;
+}
+
+big_integer binomial(unsigned n, unsigned k) {
+  if (k > n) {
+    return 0;
+  }
+  k = std::min(k, n - k);
+  // by Legendre's formula p enters C(n, k) with the exponent sum of floor(n / p^i) - floor(k / p^i)
+  // - floor((n - k) / p^i) over i >= 1, every term is 0 or 1
+  std::vector<limb_t> factors;
+  for (limb_t p : primes_up_to(k == 0 ? 0 : n)) {
+    for (unsigned a = n / p, b = k / p, c = (n - k) / p; a != 0; a /= p, b /= p, c /= p) {
+      if (a != b + c) {
+        factors.push_back(p);
+      }
+    }
+  }
+  big_integer result;
+  result._data = product_tree(factors);
+  return result;
+}
+
+big_integer primorial(unsigned n) {
+  big_integer result;
+  result._data = product_tree(primes_up_to(n));
+  return result;
+}
+
+// Works on the two's complement of the operands without materializing it: a negative value with magnitude m is
+// ~(m - 1), so in one pass over the limbs the borrows of m - 1 and the carry of the result's magnitude ~r + 1 are
+// propagated on the fly. They stop at the first nonzero limb, the rest of the pass only flips bits.
+template <class Operation>
+void big_integer::bit_operation(const big_integer& rhs) {
+  Operation operation;
+  size_t n = length();
+  size_t m = rhs.length();
+  bool a_sign = _sign && n != 0;
+  bool b_sign = rhs._sign && m != 0;
+  bool sign = operation(a_sign, b_sign);
+  limb_t a_mask = a_sign ? ~limb_t(0) : 0;
+  limb_t b_mask = b_sign ? ~limb_t(0) : 0;
+  limb_t r_mask = sign ? ~limb_t(0) : 0;
+  limb_t a_borrow = a_sign;
+  limb_t b_borrow = b_sign;
+  limb_t r_carry = sign;
+  size_t len = std::max(n, m);
+  _data.resize(len);
+  limb_t* r = _data.data();
+  const limb_t* b = rhs._data.data();
+  size_t i = 0;
+  for (; i < len && (a_borrow | b_borrow | r_carry) != 0; i++) {
+    limb_t x = r[i];
+    limb_t y = i < m ? b[i] : 0;
+    limb_t z = operation((x - a_borrow) ^ a_mask, (y - b_borrow) ^ b_mask);
+    a_borrow &= x == 0;
+    b_borrow &= y == 0;
+    r[i] = (z ^ r_mask) + r_carry;
+    r_carry &= r[i] == 0;
+  }
+  for (; i < std::min(len, m); i++) {
+    r[i] = operation(r[i] ^ a_mask, b[i] ^ b_mask) ^ r_mask;
+  }
+  for (; i < len; i++) {
+    r[i] = operation(r[i] ^ a_mask, b_mask) ^ r_mask;
+  }
+  if (r_carry != 0) {
+    _data.push_back(1);
+  }
+  _sign = sign;
+  trim();
+}
+
+big_integer& big_integer::operator&=(const big_integer& rhs) {
+  bit_operation<std::bit_and<limb_t>>(rhs);
+  return *this;
+}
+
+big_integer& big_integer::operator|=(const big_integer& rhs) {
+  bit_operation<std::bit_or<limb_t>>(rhs);
+  return *this;
+}
+
+big_integer& big_integer::operator^=(const big_integer& rhs) {
+  bit_operation<std::bit_xor<limb_t>>(rhs);
+  return *this;
+}
+
+// whole limbs are moved with one copy, the bits within a limb with one pass of lshift_limbs / rshift_limbs
+big_integer& big_integer::operator<<=(int rhs) {
+  if (rhs < 0) {
+    throw std::invalid_argument("Negative shift");
+  }
+  size_t n = length();
+  if (n == 0) {
+    return *this;
+  }
+  size_t big_shift = rhs / EXP;
+  size_t small_shift = rhs % EXP;
+  if (_data.capacity() < n + big_shift + 1) {
+    // shifts straight into the new storage instead of copying twice
+    limb_vector result(n + big_shift + 1);
+    if (small_shift == 0) {
+      std::copy(_data.begin(), _data.end(), result.data() + big_shift);
+    } else {
+      result[n + big_shift] = lshift_limbs(result.data() + big_shift, _data.data(), n, small_shift);
+    }
+    std::swap(_data, result);
+  } else {
+    _data.resize(n + big_shift + 1);
+    limb_t* data = _data.data();
+    if (small_shift == 0) {
+      std::copy_backward(data, data + n, data + n + big_shift);
+    } else {
+      data[n + big_shift] = lshift_limbs(data + big_shift, data, n, small_shift);
+    }
+    std::fill(data, data + big_shift, 0);
+  }
+  trim();
+  return *this;
+}
+
+// rounds toward negative infinity: the magnitude of a negative value grows by one if any bit shifted out is set
+big_integer& big_integer::operator>>=(int rhs) {
+  if (rhs < 0) {
+    throw std::invalid_argument("Negative shift");
+  }
+  size_t n = length();
+  size_t big_shift = rhs / EXP;
+  size_t small_shift = rhs % EXP;
+  if (big_shift >= n) {
+    return *this = _sign && n != 0 ? -1 : 0;
+  }
+  limb_t* data = _data.data();
+  bool round_up = _sign && (std::any_of(data, data + big_shift, [](limb_t x) { return x != 0; }) ||
+                            (data[big_shift] & ((limb_t(1) << small_shift) - 1)) != 0);
+  if (small_shift == 0) {
+    std::copy(data + big_shift, data + n, data);
+  } else {
+    rshift_limbs(data, data + big_shift, n - big_shift, small_shift);
+  }
+  _data.resize(n - big_shift);
+  trim();
+  if (round_up) {
+    size_t i = 0;
+    while (i < length() && ++_data[i] == 0) {
+      i++;
+    }
+    if (i == length()) {
+      _data.push_back(1);
+    }
+  }
+  return *this;
+}
+
+big_integer big_integer::operator+() const {
+  return *this;
+}
+
+big_integer big_integer::operator-() const {
+  big_integer tmp = *this;
+  tmp._sign = !tmp._sign;
+  return tmp;
+}
+
+big_integer big_integer::operator~() const {
+  big_integer result = *this;
+  result._sign = !result._sign;
+  --result;
+  return result;
+}
+
+big_integer& big_integer::operator++() {
+  if (!_sign) {
+    limb_t carry = 1;
+    for (size_t i = 0; i < _data.size() && carry > 0; ++i) {
+      dlimb_t sum = dlimb_cast(_data[i]) + carry;
+      _data[i] = limb_cast(sum);
+      carry = sum >> EXP;
+    }
+    if (carry > 0) {
+      _data.push_back(limb_cast(carry));
+    }
+  } else {
+    _sign = false;
+    --(*this);
+    if (!eq_zero()) {
+      _sign = true;
+    }
+  }
+  return *this;
+}
+
+big_integer big_integer::operator++(int) {
+  big_integer tmp = *this;
+  ++(*this);
+  return tmp;
+}
+
+big_integer& big_integer::operator--() {
+  if (!_sign) {
+    if (eq_zero()) {
+      _sign = true;
+      _data.push_back(1);
+    } else {
+      limb_t borrow = 1;
+      for (size_t i = 0; i < _data.size() && borrow > 0; ++i) {
+        borrow = _data[i] == 0;
+        --_data[i];
+      }
+    }
+    trim();
+  } else {
+    _sign = false;
+    ++(*this);
+    _sign = true;
+  }
+  return *this;
+}
+
+big_integer big_integer::operator--(int) {
+  big_integer tmp = big_integer(*this);
+  --(*this);
+  return tmp;
+}
+
+big_integer operator+(const big_integer& a, const big_integer& b) {
+  return big_integer(a) + b;
+}
+
+big_integer operator+(big_integer&& a, const big_integer& b) {
+  return std::move(a += b);
+}
+
+big_integer operator+(const big_integer& a, big_integer&& b) {
+  return std::move(b += a);
+}
+
+big_integer operator+(big_integer&& a, big_integer&& b) {
+  return std::move(a += b);
+}
+
+big_integer operator-(const big_integer& a, const big_integer& b) {
+  return big_integer(a) - b;
+}
+
+big_integer operator-(big_integer&& a, const big_integer& b) {
+  return std::move(a -= b);
+}
+
+big_integer operator*(const big_integer& a, const big_integer& b) {
+  return big_integer(a) * b;
+}
+
+big_integer operator*(big_integer&& a, const big_integer& b) {
+  return std::move(a *= b);
+}
+
+big_integer operator*(const big_integer& a, big_integer&& b) {
+  return std::move(b *= a);
+}
+
+big_integer operator*(big_integer&& a, big_integer&& b) {
+  return std::move(a *= b);
+}
+
+big_integer operator/(const big_integer& a, const big_integer& b) {
+  return big_integer(a) / b;
+}
+
+big_integer operator/(big_integer&& a, const big_integer& b) {
+  return std::move(a /= b);
+}
+
+big_integer operator%(const big_integer& a, const big_integer& b) {
+  return big_integer(a) % b;
+}
+
+big_integer operator%(big_integer&& a, const big_integer& b) {
+  return std::move(a %= b);
+}
+
+big_integer operator&(const big_integer& a, const big_integer& b) {
+  return big_integer(a) & b;
+}
+
+big_integer operator&(big_integer&& a, const big_integer& b) {
+  return std::move(a &= b);
+}
+
+big_integer operator&(const big_integer& a, big_integer&& b) {
+  return std::move(b &= a);
+}
+
+big_integer operator&(big_integer&& a, big_integer&& b) {
+  return std::move(a &= b);
+}
+
+big_integer operator|(const big_integer& a, const big_integer& b) {
+  return big_integer(a) | b;
+}
+
+big_integer operator|(big_integer&& a, const big_integer& b) {
+  return std::move(a |= b);
+}
+
+big_integer operator|(const big_integer& a, big_integer&& b) {
+  return std::move(b |= a);
+}
+
+big_integer operator|(big_integer&& a, big_integer&& b) {
+  return std::move(a |= b);
+}
+
+big_integer operator^(const big_integer& a, const big_integer& b) {
+  return big_integer(a) ^ b;
+}
+
+big_integer operator^(big_integer&& a, const big_integer& b) {
+  return std::move(a ^= b);
+}
+
+big_integer operator^(const big_integer& a, big_integer&& b) {
+  return std::move(b ^= a);
+}
+
+big_integer operator^(big_integer&& a, big_integer&& b) {
+  return std::move(a ^= b);
+}
+
+big_integer operator<<(const big_integer& a, int b) {
+  return big_integer(a) << b;
+}
+
+big_integer operator<<(big_integer&& a, int b) {
+  return std::move(a <<= b);
+}
+
+big_integer operator>>(const big_integer& a, int b) {
+  return big_integer(a) >> b;
+}
+
+big_integer operator>>(big_integer&& a, int b) {
+  return std::move(a >>= b);
+}
+
+// The fused kernels build the result in the storage of r, reserved once for the whole expression, unless r is an
+// operand that is still read afterwards.
+
+void mul_add(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& c) {
+  big_integer tmp;
+  big_integer& dst = &r == &a || &r == &b || &r == &c ? tmp : r;
+  size_t n = a.length();
+  size_t m = b.length();
+  dst._data.clear();
+  if (n != 0 && m != 0) {
+    dst._data.reserve(std::max(n + m, c.length()) + 1);
+    dst._data.resize(n + m);
+    if (&a == &b || a._data == b._data) {
+      sqr_limbs(dst._data.data(), a._data.data(), n);
+    } else if (n >= m) {
+      mul_limbs(dst._data.data(), a._data.data(), n, b._data.data(), m);
+    } else {
+      mul_limbs(dst._data.data(), b._data.data(), m, a._data.data(), n);
+    }
+    dst.trim();
+  }
+  dst._sign = a._sign ^ b._sign;
+  dst += c;
+  if (&dst == &tmp) {
+    swap(r, tmp);
+  }
+}
+
+void add_mod(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& m) {
+  if (m.eq_zero()) {
+    throw std::invalid_argument("Cannot divide by zero");
+  }
+  if (&r == &m) {
+    big_integer mod = m;
+    add_mod(r, a, b, mod);
+    return;
+  }
+  if (&r == &b) {
+    r += a;
+  } else {
+    if (&r != &a) {
+      r = a;
+    }
+    r += b;
+  }
+  // operands already reduced leave a sum below 2|m|, which one subtraction reduces
+  if (r.abs_great_or_eq(m)) {
+    r.sub_abs(m);
+    if (r.abs_great_or_eq(m)) {
+      r %= m;
+    }
+  }
+}
+
+void shl_add(big_integer& r, const big_integer& a, int shift, const big_integer& b) {
+  if (shift < 0) {
+    throw std::invalid_argument("Negative shift");
+  }
+  big_integer tmp;
+  big_integer& dst = &r == &b ? tmp : r;
+  size_t n = a.length();
+  size_t big_shift = shift / EXP;
+  size_t small_shift = shift % EXP;
+  size_t size = std::max(n + big_shift + 1, b.length()) + 1;
+  if (&dst == &a) {
+    dst._data.reserve(size);
+    dst <<= shift;
+  } else if (n == 0) {
+    dst = 0;
+  } else {
+    dst._data.clear();
+    dst._data.reserve(size);
+    dst._data.resize(n + big_shift + 1);
+    limb_t* data = dst._data.data();
+    if (small_shift == 0) {
+      std::copy(a._data.begin(), a._data.end(), data + big_shift);
+    } else {
+      data[n + big_shift] = lshift_limbs(data + big_shift, a._data.data(), n, small_shift);
+    }
+    dst._sign = a._sign;
+    dst.trim();
+  }
+  dst += b;
+  if (&dst == &tmp) {
+    swap(r, tmp);
+  }
+}
+
+// this += a[0..n) * b[0..m) with the product negated if `negative`; neither operand may alias _data.
+// The sum is kept in one more limb than either term, so a difference that went below zero shows in the top limb.
+void big_integer::mul_accumulate(const limb_t* a, size_t n, const limb_t* b, size_t m, bool negative) {
+  if (n < m) {
+    std::swap(a, b);
+    std::swap(n, m);
+  }
+  if (m == 0) {
+    return;
+  }
+  if (eq_zero()) {
+    _sign = negative;
+  }
+  bool subtract = _sign != negative;
+  size_t k = std::max(length(), n + m) + 1;
+  _data.resize(k);
+  limb_t* r = _data.data();
+  if (m < KARATSUBA_THRESHOLD) {
+    for (size_t i = 0; i < m; i++) {
+      size_t j = i + n;
+      if (subtract) {
+        limb_t borrow = submul_limbs(r + i, a, n, b[i]);
+        for (; borrow != 0 && j < k; j++) {
+          limb_t cur = r[j];
+          r[j] = cur - borrow;
+          borrow = cur < borrow;
+        }
+      } else {
+        limb_t carry = addmul_limbs(r + i, a, n, b[i]);
+        for (; carry != 0 && j < k; j++) {
+          r[j] += carry;
+          carry = r[j] < carry;
+        }
+      }
+    }
+  } else {
+    limb_vector product(n + m);
+    mul_limbs(product.data(), a, n, b, m);
+    if (subtract) {
+      sub_limbs(r, r, k, product.data(), n + m);
+    } else {
+      add_limbs(r, r, k, product.data(), n + m);
+    }
+  }
+  if (subtract && r[k - 1] != 0) {
+    negate_limbs(r, k);
+    _sign = !_sign;
+  }
+  trim();
+  _sign = _sign && !eq_zero();
+}
+
+void addmul(big_integer& acc, const big_integer& x, const big_integer& y) {
+  if (&acc == &x || &acc == &y) {
+    big_integer operand = acc;
+    addmul(acc, &acc == &x ? operand : x, &acc == &y ? operand : y);
+    return;
+  }
+  acc.mul_accumulate(x._data.data(), x.length(), y._data.data(), y.length(), x._sign ^ y._sign);
+}
+
+void submul(big_integer& acc, const big_integer& x, const big_integer& y) {
+  if (&acc == &x || &acc == &y) {
+    big_integer operand = acc;
+    submul(acc, &acc == &x ? operand : x, &acc == &y ? operand : y);
+    return;
+  }
+  acc.mul_accumulate(x._data.data(), x.length(), y._data.data(), y.length(), !(x._sign ^ y._sign));
+}
+
+void addmul_ui(big_integer& acc, const big_integer& x, unsigned long y) {
+  if (&acc == &x) {
+    big_integer operand = acc;
+    addmul_ui(acc, operand, y);
+    return;
+  }
+  // an unsigned long takes two limbs when limbs are 32-bit
+  dlimb_t value = y;
+  limb_t b[2] = {limb_cast(value), limb_cast(value >> EXP)};
+  size_t m = b[1] != 0 ? 2 : b[0] != 0;
+  acc.mul_accumulate(x._data.data(), x.length(), b, m, x._sign);
+}
+
+void submul_ui(big_integer& acc, const big_integer& x, unsigned long y) {
+  if (&acc == &x) {
+    big_integer operand = acc;
+    submul_ui(acc, operand, y);
+    return;
+  }
+  dlimb_t value = y;
+  limb_t b[2] = {limb_cast(value), limb_cast(value >> EXP)};
+  size_t m = b[1] != 0 ? 2 : b[0] != 0;
+  acc.mul_accumulate(x._data.data(), x.length(), b, m, !x._sign);
+}
+
+bool operator==(const big_integer& a, const big_integer& b) {
+  return (a.eq_zero() && b.eq_zero()) || (a._sign == b._sign && a._data == b._data);
+}
+
+bool operator>(const big_integer& a, const big_integer& b) {
+  if (a._sign != b._sign) {
+    return !a._sign && !(a.eq_zero() && b.eq_zero());
+  }
+  if (a._data.size() != b._data.size()) {
+    return (a._data.size() > b._data.size()) ^ a._sign;
+  }
+
+  for (size_t i = a.length(); i > 0; --i) {
+    if (a[i - 1] != b[i - 1]) {
+      return (a[i - 1] > b[i - 1]) ^ a._sign;
+    }
+  }
+
+  return false;
+}
+
+bool operator<=(const big_integer& a, const big_integer& b) {
+  return !(a > b);
+}
+
+bool operator>=(const big_integer& a, const big_integer& b) {
+  return !(b > a);
+}
+
+bool operator!=(const big_integer& a, const big_integer& b) {
+  return !(a == b);
+}
+
+bool operator<(const big_integer& a, const big_integer& b) {
+  return !(a >= b);
+}
+
+// powers[i] = 10^(DIGITS_CNT * 2^i) for every i with DIGITS_CNT * 2^i < digits, and at least INT_MOD
+static std::vector<limb_vector> decimal_powers(size_t digits) {
+  std::vector<limb_vector> powers = {{INT_MOD}};
+  while ((DIGITS_CNT << powers.size()) < digits) {
+    const limb_vector& last = powers.back();
+    limb_vector next(last.size() * 2);
+    sqr_limbs(next.data(), last.data(), last.size());
+    trim_limbs(next);
+    powers.push_back(std::move(next));
+  }
+  return powers;
+}
+
+// Parses the decimal digits [first, last): the low DIGITS_CNT * 2^k digits, with DIGITS_CNT * 2^k the largest
+// such number below the length, and the rest are parsed recursively and combined as
+// high * 10^(DIGITS_CNT * 2^k) + low
+static limb_vector from_decimal(const char* first, const char* last, const std::vector<limb_vector>& powers) {
+  size_t len = last - first;
+  limb_vector result;
+  if (len <= DIGITS_CNT * FROM_STRING_THRESHOLD) {
+    size_t chunk_len = (len - 1) % DIGITS_CNT + 1;
+    for (; first != last; first += chunk_len, chunk_len = DIGITS_CNT) {
+      limb_t chunk = 0;
+      for (size_t i = 0; i < chunk_len; i++) {
+        chunk = chunk * INT_BASE + (first[i] - '0');
+      }
+      limb_t carry = mul_1_limbs(result.data(), result.data(), result.size(), exp(INT_BASE, chunk_len));
+      if (!result.empty()) {
+        carry += add_limbs(result.data(), result.data(), result.size(), &chunk, 1);
+      } else {
+        carry = chunk;
+      }
+      if (carry != 0) {
+        result.push_back(carry);
+      }
+    }
+    return result;
+  }
+  size_t k = 0;
+  while ((DIGITS_CNT << (k + 1)) < len) {
+    k++;
+  }
+  const char* middle = last - (DIGITS_CNT << k);
+  limb_vector high = from_decimal(first, middle, powers);
+  limb_vector low = from_decimal(middle, last, powers);
+  if (high.empty()) {
+    return low;
+  }
+  const limb_vector& power = powers[k];
+  result.resize(high.size() + power.size());
+  if (high.size() >= power.size()) {
+    mul_limbs(result.data(), high.data(), high.size(), power.data(), power.size());
+  } else {
+    mul_limbs(result.data(), power.data(), power.size(), high.data(), high.size());
+  }
+  add_limbs(result.data(), result.data(), result.size(), low.data(), low.size());
+  trim_limbs(result);
+  return result;
+}
+
+// Decimal digits a leaf of to_decimal produces at most: a number below TO_STRING_THRESHOLD limbs in whole chunks
+static constexpr size_t DECIMAL_LEAF_DIGITS =
+    (TO_STRING_THRESHOLD * EXP * 30103 / 100000 / DIGITS_CNT + 2) * DIGITS_CNT;
+
+// Passes count zeros to sink
+template <class Sink>
+static void put_zeros(size_t count, Sink& sink) {
+  char zeros[256];
+  std::fill(std::begin(zeros), std::end(zeros), '0');
+  for (; count > sizeof(zeros); count -= sizeof(zeros)) {
+    sink(zeros, sizeof(zeros));
+  }
+  sink(zeros, count);
+}
+
+// Passes the digits of a, a < 10^(DIGITS_CNT * 2^k), to sink(data, size) most significant first, in pieces of at
+// most DECIMAL_LEAF_DIGITS; zero-padded to DIGITS_CNT * 2^k digits if `pad`, without leading zeros otherwise.
+// powers[i] = 10^(DIGITS_CNT * 2^i).
+template <class Sink>
+static void to_decimal(limb_vector a, const std::vector<limb_vector>& powers, size_t k, bool pad, Sink& sink) {
+  if (k < 2 || a.size() < TO_STRING_THRESHOLD) {
+    char digits[DECIMAL_LEAF_DIGITS];
+    char* last = std::end(digits);
+    char* first = last;
+    while (!a.empty()) {
+      limb_t chunk = divrem_1_limbs(a.data(), a.data(), a.size(), INT_MOD);
+      trim_limbs(a);
+      for (size_t i = 0; i < DIGITS_CNT; i++) {
+        *--first = static_cast<char>('0' + chunk % INT_BASE);
+        chunk /= INT_BASE;
+      }
+    }
+    if (pad) {
+      put_zeros((DIGITS_CNT << k) - (last - first), sink);
+    } else {
+      first = std::find_if(first, last, [](char c) { return c != '0'; });
+    }
+    sink(first, last - first);
+    return;
+  }
+  const limb_vector& power = powers[k - 1];
+  limb_vector q;
+  if (a.size() >= power.size()) {
+    divmod_limbs(q, a, power);
+  }
+  if (q.empty()) {
+    if (pad) {
+      put_zeros(DIGITS_CNT << (k - 1), sink);
+    }
+    to_decimal(std::move(a), powers, k - 1, pad, sink);
+    return;
+  }
+  to_decimal(std::move(q), powers, k - 1, pad, sink);
+  to_decimal(std::move(a), powers, k - 1, true, sink);
+}
+
+static constexpr char RADIX_DIGITS[] = "0123456789abcdefghijklmnopqrstuv";
+
+// log2(base) for the bases 2, 8, 16 and 32, 0 for base 10
+static unsigned radix_bits(int base) {
+  switch (base) {
+  case 2:
+    return 1;
+  case 8:
+    return 3;
+  case 16:
+    return 4;
+  case 32:
+    return 5;
+  case 10:
+    return 0;
+  default:
+    throw std::invalid_argument("Base must be 2, 8, 10, 16 or 32");
+  }
+}
+
+// the value of the digit c in bases up to 32 in either case, 32 if c is not such a digit
+static unsigned digit_value(char c) {
+  if ('0' <= c && c <= '9') {
+    return c - '0';
+  }
+  if ('a' <= c && c <= 'v') {
+    return c - 'a' + 10;
+  }
+  if ('A' <= c && c <= 'V') {
+    return c - 'A' + 10;
+  }
+  return 32;
+}
+
+// Parses the digits [first, last) in base 2^bits by or-ing the bits of every digit into place
+static limb_vector from_radix(const char* first, const char* last, unsigned bits) {
+  limb_vector result(((last - first) * bits + EXP - 1) / EXP);
+  for (size_t pos = 0; last != first; pos += bits) {
+    limb_t digit = digit_value(*--last);
+    result[pos / EXP] |= digit << (pos % EXP);
+    if (pos % EXP + bits > EXP) {
+      result[pos / EXP + 1] |= digit >> (EXP - pos % EXP);
+    }
+  }
+  trim_limbs(result);
+  return result;
+}
+
+// Writes the digits low .. low + (last - first) of a[0..n) in base 2^bits to [first, last), most significant
+// first, by slicing bits out of the limbs
+static void to_radix(char* first, char* last, const limb_t* a, size_t n, unsigned bits, size_t low) {
+  limb_t mask = (limb_t{1} << bits) - 1;
+  for (size_t pos = low * bits; last != first; pos += bits) {
+    limb_t digit = a[pos / EXP] >> (pos % EXP);
+    if (pos % EXP + bits > EXP && pos / EXP + 1 < n) {
+      digit |= a[pos / EXP + 1] << (EXP - pos % EXP);
+    }
+    *--last = RADIX_DIGITS[digit & mask];
+  }
+}
+
+// an upper bound of the number of digits of the trimmed magnitude a in the given base
+static size_t max_digits(const limb_vector& a, int base) {
+  unsigned bits = radix_bits(base);
+  if (a.empty()) {
+    return 1;
+  }
+  size_t width = (a.size() - 1) * EXP + std::bit_width(a.back());
+  // a limb holds less than EXP * log10(2) < EXP * 0.30103 decimal digits
+  return bits == 0 ? width * 30103 / 100000 + 1 : (width + bits - 1) / bits;
+}
+
+// Passes the digits of the trimmed magnitude a in the given base to sink(data, size), most significant first and in
+// pieces of a few hundred characters. Only the quotients on one path of the decimal recursion are kept, never all
+// the digits at once.
+template <class Sink>
+static void write_digits(const limb_vector& a, int base, Sink&& sink) {
+  unsigned bits = radix_bits(base);
+  if (a.empty()) {
+    sink("0", 1);
+    return;
+  }
+  if (bits != 0) {
+    char digits[256];
+    for (size_t low = max_digits(a, base); low != 0;) {
+      size_t count = std::min(low, sizeof(digits));
+      low -= count;
+      to_radix(digits, digits + count, a.data(), a.size(), bits, low);
+      sink(digits, count);
+    }
+    return;
+  }
+  // splits the number by the largest square of INT_MOD below it, the halves are converted recursively
+  std::vector<limb_vector> powers = decimal_powers(max_digits(a, base));
+  to_decimal(a, powers, powers.size(), false, sink);
+}
+
+std::string to_string(const big_integer& a, int base) {
+  std::string s;
+  s.reserve(max_digits(a._data, base) + 1);
+  if (a._sign && !a.eq_zero()) {
+    s.push_back('-');
+  }
+  write_digits(a._data, base, [&s](const char* data, size_t size) { s.append(data, size); });
+  return s;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const big_integer& a, int base) {
+  if (a._sign && !a.eq_zero()) {
+    if (first == last) {
+      return {last, std::errc::value_too_large};
+    }
+    *first++ = '-';
+  }
+  bool fits = true;
+  write_digits(a._data, base, [&](const char* data, size_t size) {
+    fits = fits && size <= static_cast<size_t>(last - first);
+    if (fits) {
+      first = std::copy(data, data + size, first);
+    }
+  });
+  if (!fits) {
+    return {last, std::errc::value_too_large};
+  }
+  return {first, std::errc()};
+}
+
+limb_t big_integer::div_uint(const limb_t& rhs) {
+  limb_t remainder = divrem_1_limbs(_data.data(), _data.data(), length(), rhs);
+  trim();
+  return remainder;
+}
+
+// the number of bytes of the magnitude a[0..n), n is trimmed
+static size_t magnitude_bytes(const limb_t* a, size_t n) {
+  return n == 0 ? 0 : ((n - 1) * EXP + std::bit_width(a[n - 1]) + 7) / 8;
+}
+
+// out[0..size) = the low size bytes of a in the given order
+static void write_magnitude(uint8_t* out, size_t size, const limb_t* a, std::endian order) {
+  if constexpr (std::endian::native == std::endian::little) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(a);
+    if (order == std::endian::little) {
+      std::copy(bytes, bytes + size, out);
+    } else {
+      std::reverse_copy(bytes, bytes + size, out);
+    }
+  } else {
+    for (size_t i = 0; i < size; i++) {
+      size_t j = order == std::endian::little ? i : size - 1 - i;
+      out[j] = static_cast<uint8_t>(a[i / sizeof(limb_t)] >> (8 * (i % sizeof(limb_t))));
+    }
+  }
+}
+
+// a = data[0..size) in the given order, a has ceil(size / sizeof(limb_t)) zero limbs
+static void read_magnitude(limb_t* a, const uint8_t* data, size_t size, std::endian order) {
+  if constexpr (std::endian::native == std::endian::little) {
+    auto* bytes = reinterpret_cast<uint8_t*>(a);
+    if (order == std::endian::little) {
+      std::copy(data, data + size, bytes);
+    } else {
+      std::reverse_copy(data, data + size, bytes);
+    }
+  } else {
+    for (size_t i = 0; i < size; i++) {
+      size_t j = order == std::endian::little ? i : size - 1 - i;
+      a[i / sizeof(limb_t)] |= limb_t{data[j]} << (8 * (i % sizeof(limb_t)));
+    }
+  }
+}
+
+std::vector<uint8_t> export_bytes(const big_integer& a, std::endian order) {
+  std::vector<uint8_t> result(magnitude_bytes(a._data.data(), a.length()));
+  write_magnitude(result.data(), result.size(), a._data.data(), order);
+  return result;
+}
+
+big_integer import_bytes(const uint8_t* data, size_t size, std::endian order) {
+  big_integer result;
+  result._data.resize((size + sizeof(limb_t) - 1) / sizeof(limb_t));
+  read_magnitude(result._data.data(), data, size, order);
+  result.trim();
+  return result;
+}
+
+void serialize(const big_integer& a, std::vector<uint8_t>& out) {
+  size_t size = magnitude_bytes(a._data.data(), a.length());
+  uint64_t header = uint64_t{size} * 2 + (a._sign && size != 0);
+  for (; header >= 0x80; header >>= 7) {
+    out.push_back(static_cast<uint8_t>(header | 0x80));
+  }
+  out.push_back(static_cast<uint8_t>(header));
+  size_t at = out.size();
+  out.resize(at + size);
+  write_magnitude(out.data() + at, size, a._data.data(), std::endian::little);
+}
+
+big_integer deserialize(const uint8_t* data, size_t size, size_t& used) {
+  uint64_t header = 0;
+  size_t i = 0;
+  for (unsigned shift = 0;; shift += 7) {
+    if (i == size || shift >= 64 || (uint64_t{data[i] & 0x7fu} << shift >> shift) != (data[i] & 0x7fu)) {
+      throw std::invalid_argument("Invalid big_integer encoding");
+    }
+    header |= uint64_t{data[i] & 0x7fu} << shift;
+    if ((data[i++] & 0x80) == 0) {
+      break;
+    }
+  }
+  if (header / 2 > size - i) {
+    throw std::invalid_argument("Invalid big_integer encoding");
+  }
+  big_integer result = import_bytes(data + i, static_cast<size_t>(header / 2), std::endian::little);
+  result._sign = (header & 1) != 0 && !result.eq_zero();
+  used = i + static_cast<size_t>(header / 2);
+  return result;
+}
+
+// the base selected by the basefield flags of a stream, 0 if none is
+static int stream_base(const std::ios_base& stream) {
+  switch (stream.flags() & std::ios_base::basefield) {
+  case std::ios_base::hex:
+    return 16;
+  case std::ios_base::oct:
+    return 8;
+  case std::ios_base::dec:
+    return 10;
+  default:
+    return 0;
+  }
+}
+
+// hex digits in uppercase, for the uppercase flag
+static void to_upper_digits(char* first, char* last) {
+  for (; first != last; ++first) {
+    if (*first >= 'a' && *first <= 'z') {
+      *first = static_cast<char>(*first - 'a' + 'A');
+    }
+  }
+}
+
+std::ostream& operator<<(std::ostream& out, const big_integer& a) {
+  int base = stream_base(out);
+  if (base == 0) {
+    base = 10;
+  }
+  // like built-in integers: '+' only in decimal, no base prefix for zero
+  std::ios_base::fmtflags flags = out.flags();
+  bool upper = (flags & std::ios_base::uppercase) && base == 16;
+  std::string prefix;
+  if (a._sign && !a.eq_zero()) {
+    prefix = "-";
+  } else if ((flags & std::ios_base::showpos) && base == 10) {
+    prefix = "+";
+  }
+  if ((flags & std::ios_base::showbase) && !a.eq_zero() && base != 10) {
+    prefix += base == 8 ? "0" : upper ? "0X" : "0x";
+  }
+  if (out.width() != 0) {
+    // the padding depends on the length
+    std::string digits;
+    write_digits(a._data, base, [&](const char* data, size_t size) { digits.append(data, size); });
+    if (upper) {
+      to_upper_digits(digits.data(), digits.data() + digits.size());
+    }
+    if ((flags & std::ios_base::adjustfield) == std::ios_base::internal) {
+      size_t length = prefix.size() + digits.size();
+      size_t width = static_cast<size_t>(out.width());
+      prefix.append(width > length ? width - length : 0, out.fill());
+      out.width(0);
+    }
+    return out << prefix + digits;
+  }
+  std::ostream::sentry sentry(out);
+  if (!sentry) {
+    return out;
+  }
+  std::streambuf* buf = out.rdbuf();
+  auto put = [&](const char* data, size_t size) {
+    return buf->sputn(data, static_cast<std::streamsize>(size)) == static_cast<std::streamsize>(size);
+  };
+  bool ok = put(prefix.data(), prefix.size());
+  write_digits(a._data, base, [&](const char* data, size_t size) {
+    if (!upper) {
+      ok = ok && put(data, size);
+      return;
+    }
+    char chunk[256];
+    for (size_t i = 0; i < size; i += sizeof(chunk)) {
+      size_t n = std::min(sizeof(chunk), size - i);
+      std::copy_n(data + i, n, chunk);
+      to_upper_digits(chunk, chunk + n);
+      ok = ok && put(chunk, n);
+    }
+  });
+  if (!ok) {
+    out.setstate(std::ios_base::badbit);
+  }
+  return out;
+}
+
+std::istream& operator>>(std::istream& in, big_integer& a) {
+  std::istream::sentry sentry(in);
+  if (!sentry) {
+    return in;
+  }
+  // like the extraction of built-in integers: an optional sign, "0x" in hex, and with no basefield set the
+  // base is taken from the prefix, "0x" for hex, "0" for octal
+  std::streambuf* buf = in.rdbuf();
+  using traits = std::istream::traits_type;
+  std::string s;
+  int base = stream_base(in);
+  int c = buf->sgetc();
+  if (c == '-' || c == '+') {
+    if (c == '-') {
+      s.push_back('-');
+    }
+    c = buf->snextc();
+  }
+  bool zero = false;
+  if ((base == 0 || base == 16) && c == '0') {
+    zero = true;
+    c = buf->snextc();
+    if (c == 'x' || c == 'X') {
+      zero = false;
+      base = 16;
+      c = buf->snextc();
+    } else if (base == 0) {
+      base = 8;
+    }
+  }
+  if (base == 0) {
+    base = 10;
+  }
+  size_t sign = s.size();
+  for (; c != traits::eof() && digit_value(traits::to_char_type(c)) < static_cast<unsigned>(base); c = buf->snextc()) {
+    s.push_back(traits::to_char_type(c));
+  }
+  std::ios_base::iostate state = c == traits::eof() ? std::ios_base::eofbit : std::ios_base::goodbit;
+  if (s.size() == sign && !zero) {
+    state |= std::ios_base::failbit;
+  } else {
+    a = big_integer(s.size() == sign ? "0" : s, base);
+  }
+  in.setstate(state);
+  return in;
 }
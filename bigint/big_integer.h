@@ -1,14 +1,24 @@
 #pragma once
 
+#include "limb_vector.h"
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
 #include <iosfwd>
 #include <string>
 #include <vector>
 
+template <size_t Bits>
+struct fixed_big_integer;
+
 struct big_integer {
   big_integer();
 
   big_integer(const big_integer& other);
 
+  big_integer(big_integer&& other) noexcept;
+
   big_integer(int);
 
   big_integer(unsigned);
@@ -21,12 +31,15 @@ struct big_integer {
 
   big_integer(unsigned long long a);
 
-  explicit big_integer(const std::string& str);
+  // digits in base 2, 8, 10, 16 or 32 after an optional '-', letters in either case
+  explicit big_integer(const std::string& str, int base = 10);
 
   ~big_integer();
 
   big_integer& operator=(const big_integer& other);
 
+  big_integer& operator=(big_integer&& other) noexcept;
+
   big_integer& operator+=(const big_integer& rhs);
 
   big_integer& operator-=(const big_integer& rhs);
@@ -73,37 +86,50 @@ struct big_integer {
 
   friend bool operator>=(const big_integer& a, const big_integer& b);
 
-  friend std::string to_string(const big_integer& a);
+  friend std::string to_string(const big_integer& a, int base);
+  friend std::to_chars_result to_chars(char* first, char* last, const big_integer& a, int base);
+  friend std::ostream& operator<<(std::ostream& out, const big_integer& a);
   friend void swap(big_integer& a, big_integer& b);
+  friend big_integer pow_mod(const big_integer& base, const big_integer& exp, const big_integer& mod);
+  friend big_integer gcd(const big_integer& a, const big_integer& b);
+  friend big_integer extended_gcd(const big_integer& a, const big_integer& b, big_integer& x, big_integer& y);
+  friend big_integer iroot(const big_integer& a, unsigned n);
+  friend big_integer factorial(unsigned n);
+  friend big_integer binomial(unsigned n, unsigned k);
+  friend big_integer primorial(unsigned n);
+  friend void mul_add(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& c);
+  friend void add_mod(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& m);
+  friend void shl_add(big_integer& r, const big_integer& a, int shift, const big_integer& b);
+  friend void addmul(big_integer& acc, const big_integer& x, const big_integer& y);
+  friend void submul(big_integer& acc, const big_integer& x, const big_integer& y);
+  friend void addmul_ui(big_integer& acc, const big_integer& x, unsigned long y);
+  friend void submul_ui(big_integer& acc, const big_integer& x, unsigned long y);
+  friend std::vector<uint8_t> export_bytes(const big_integer& a, std::endian order);
+  friend big_integer import_bytes(const uint8_t* data, size_t size, std::endian order);
+  friend void serialize(const big_integer& a, std::vector<uint8_t>& out);
+  friend big_integer deserialize(const uint8_t* data, size_t size, size_t& used);
+  friend struct montgomery_context;
+  friend struct big_integer_modulus;
+  template <size_t Bits>
+  friend struct fixed_big_integer;
 
 private:
-  static bool sub_in_pos(big_integer& lhs, const big_integer& rhs, size_t pos);
-
-  template <bool ignore_last_carry>
-  static void add_in_pos(big_integer& lhs, const big_integer& rhs, size_t pos);
+  void add_abs(const big_integer& rhs);
 
-  template <bool ignore_sign>
-  void add_with_ignore(const big_integer& rhs);
+  void sub_abs(const big_integer& rhs);
 
-  template <bool ignore_sign>
-  void sub_with_ignore(const big_integer& rhs);
+  void mul_accumulate(const limb_t* a, size_t n, const limb_t* b, size_t m, bool negative);
 
   bool abs_great_or_eq(const big_integer& rhs) const;
 
-  void div_uint(const uint32_t& rhs);
-
-  friend big_integer mul_uint(const big_integer& a, const uint32_t& b);
+  limb_t div_uint(const limb_t& rhs);
 
-  uint32_t operator[](size_t index) const;
-  uint32_t& operator[](size_t index);
-
-  static void bit_negation(big_integer& a);
+  limb_t operator[](size_t index) const;
+  limb_t& operator[](size_t index);
 
   template <bool return_remainder>
   big_integer& abstract_division(const big_integer& rhs);
 
-  static big_integer& shift_left(big_integer& a, size_t shift);
-
   template <class Operation>
   void bit_operation(const big_integer& rhs);
 
@@ -116,30 +142,81 @@ private:
   big_integer& divide_with_reminder(const big_integer& rhs);
 
 private:
-  std::vector<uint32_t> _data;
+  limb_vector _data;
   bool _sign{false}; // true for negatives
   big_integer& abstract_division(const big_integer& rhs);
 };
 
+// Arithmetic modulo a fixed odd modulus m in Montgomery form: x is kept as x * R mod m, where R is the smallest
+// power of the limb base above m. Only the constructor divides, exponentiations by the same modulus are division-free.
+struct montgomery_context {
+  explicit montgomery_context(const big_integer& mod);
+
+  const big_integer& modulus() const;
+
+  // base^exp mod |m|, in [0, |m|); exp must be non-negative
+  big_integer pow(const big_integer& base, const big_integer& exp) const;
+
+private:
+  big_integer _mod;
+  limb_vector _r2; // R^2 mod m
+  limb_t _neg_inv; // -m^-1 modulo the limb base
+};
+
+// Remainders by a fixed modulus m with Barrett reduction: a reciprocal of m is computed once, then every reduction
+// takes two multiplications and no division.
+struct big_integer_modulus {
+  explicit big_integer_modulus(const big_integer& mod);
+
+  const big_integer& modulus() const;
+
+  // x % m, with the sign of x like operator%
+  big_integer reduce(const big_integer& x) const;
+
+private:
+  big_integer _mod;
+  limb_vector _inv; // floor(B^2n / m) for an n-limb m and the limb base B
+};
+
 big_integer operator+(const big_integer& a, const big_integer& b);
+big_integer operator+(big_integer&& a, const big_integer& b);
+big_integer operator+(const big_integer& a, big_integer&& b);
+big_integer operator+(big_integer&& a, big_integer&& b);
 
 big_integer operator-(const big_integer& a, const big_integer& b);
+big_integer operator-(big_integer&& a, const big_integer& b);
 
 big_integer operator*(const big_integer& a, const big_integer& b);
+big_integer operator*(big_integer&& a, const big_integer& b);
+big_integer operator*(const big_integer& a, big_integer&& b);
+big_integer operator*(big_integer&& a, big_integer&& b);
 
 big_integer operator/(const big_integer& a, const big_integer& b);
+big_integer operator/(big_integer&& a, const big_integer& b);
 
 big_integer operator%(const big_integer& a, const big_integer& b);
+big_integer operator%(big_integer&& a, const big_integer& b);
 
 big_integer operator&(const big_integer& a, const big_integer& b);
+big_integer operator&(big_integer&& a, const big_integer& b);
+big_integer operator&(const big_integer& a, big_integer&& b);
+big_integer operator&(big_integer&& a, big_integer&& b);
 
 big_integer operator|(const big_integer& a, const big_integer& b);
+big_integer operator|(big_integer&& a, const big_integer& b);
+big_integer operator|(const big_integer& a, big_integer&& b);
+big_integer operator|(big_integer&& a, big_integer&& b);
 
 big_integer operator^(const big_integer& a, const big_integer& b);
+big_integer operator^(big_integer&& a, const big_integer& b);
+big_integer operator^(const big_integer& a, big_integer&& b);
+big_integer operator^(big_integer&& a, big_integer&& b);
 
 big_integer operator<<(const big_integer& a, int b);
+big_integer operator<<(big_integer&& a, int b);
 
 big_integer operator>>(const big_integer& a, int b);
+big_integer operator>>(big_integer&& a, int b);
 
 bool operator==(const big_integer& a, const big_integer& b);
 
@@ -153,6 +230,85 @@ bool operator<=(const big_integer& a, const big_integer& b);
 
 bool operator>=(const big_integer& a, const big_integer& b);
 
-std::string to_string(const big_integer& a);
+// a in base 2, 8, 10, 16 or 32 with lowercase letters; the power-of-two bases take linear time
+std::string to_string(const big_integer& a, int base = 10);
+
+// Writes a like to_string to [first, last) and returns the end of the characters, or {last, value_too_large} if they
+// do not fit; like std::to_chars, no terminating zero is written.
+std::to_chars_result to_chars(char* first, char* last, const big_integer& a, int base = 10);
+
+// Fused forms of common expressions: the result is built in the storage of r, sized once, instead of in temporaries.
+// r may be any of the operands. big_integer_expr.h maps the matching expressions onto them.
+
+// r = a * b + c
+void mul_add(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& c);
 
+// r = (a + b) % m with the sign of a + b like operator%; one subtraction instead of a division when |a + b| < 2|m|
+void add_mod(big_integer& r, const big_integer& a, const big_integer& b, const big_integer& m);
+
+// r = (a << shift) + b
+void shl_add(big_integer& r, const big_integer& a, int shift, const big_integer& b);
+
+// acc += x * y and acc -= x * y. Below the Karatsuba sizes the product is accumulated row by row straight into acc,
+// so a loop of them allocates only when acc outgrows its storage. acc may be x or y.
+void addmul(big_integer& acc, const big_integer& x, const big_integer& y);
+
+void submul(big_integer& acc, const big_integer& x, const big_integer& y);
+
+void addmul_ui(big_integer& acc, const big_integer& x, unsigned long y);
+
+void submul_ui(big_integer& acc, const big_integer& x, unsigned long y);
+
+// base^exp mod |mod|, in [0, |mod|); exp must be non-negative
+big_integer pow_mod(const big_integer& base, const big_integer& exp, const big_integer& mod);
+
+// the greatest common divisor of |a| and |b|, gcd(0, 0) = 0
+big_integer gcd(const big_integer& a, const big_integer& b);
+
+// gcd(a, b) and Bezout coefficients, a * x + b * y = gcd(a, b); for b != 0, |x| <= |b| / (2 gcd(a, b))
+big_integer extended_gcd(const big_integer& a, const big_integer& b, big_integer& x, big_integer& y);
+
+// x in [0, |m|) with a * x = 1 mod m; throws std::invalid_argument if gcd(a, m) != 1
+big_integer mod_inverse(const big_integer& a, const big_integer& m);
+
+// floor(sqrt(a)); throws std::invalid_argument for a negative a
+big_integer isqrt(const big_integer& a);
+
+// the n-th root of a rounded toward zero; throws std::invalid_argument for n = 0 and for an even n with a negative a
+big_integer iroot(const big_integer& a, unsigned n);
+
+// n!, by the prime-swing recursion: every level squares the previous one and multiplies by a product of primes
+big_integer factorial(unsigned n);
+
+// n! / (k! (n - k)!), 0 for k > n; built from its prime factorization
+big_integer binomial(unsigned n, unsigned k);
+
+// the product of the primes up to n
+big_integer primorial(unsigned n);
+
+// |a| as bytes without leading zeros, 0 has none; like mpz_export with one-byte words, the sign is dropped
+std::vector<uint8_t> export_bytes(const big_integer& a, std::endian order = std::endian::big);
+
+// the nonnegative number with the given bytes, like mpz_import with one-byte words
+big_integer import_bytes(const uint8_t* data, size_t size, std::endian order = std::endian::big);
+
+// Appends a to out: a LEB128 varint of 2 * n + (a < 0), then the n bytes of |a| least significant first.
+void serialize(const big_integer& a, std::vector<uint8_t>& out);
+
+// Reads a number written by serialize from data[0..size), `used` receives the length of its encoding;
+// throws std::invalid_argument if the encoding is truncated or malformed
+big_integer deserialize(const uint8_t* data, size_t size, size_t& used);
+
+// Threads that one multiplication of very long numbers may use, 1 by default; 0 takes the number of hardware threads.
+// Only products of many thousands of limbs are split, the result does not depend on the count.
+void set_multiplication_threads(unsigned count);
+
+unsigned multiplication_threads();
+
+// Both honour the basefield flags (std::hex, std::oct). Output also follows showbase, showpos, uppercase and the
+// adjustfield like built-in integers, so it reads back with basefield unset. It goes to the stream buffer in pieces,
+// without a string of all the digits unless a field width is set. Input accepts an optional sign, a "0x" prefix in
+// hex, and with basefield unset takes the base from the prefix like strtol.
 std::ostream& operator<<(std::ostream& out, const big_integer& a);
+
+std::istream& operator>>(std::istream& in, big_integer& a);
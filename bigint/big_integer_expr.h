@@ -0,0 +1,162 @@
+#pragma once
+
+#include "big_integer.h"
+
+#include <concepts>
+#include <type_traits>
+
+// Opt-in expression templates over big_integer. An expression started with lazy() is evaluated when it is converted
+// to big_integer or passed to assign(); a * b + c, (a + b) % m and (a << k) + b run as one fused call (mul_add,
+// add_mod, shl_add) that writes straight into the result:
+//
+//   using big_integer_expr::lazy;
+//   big_integer x = lazy(a) * b + c;
+//   assign(x, (lazy(x) + y) % m); // reuses the storage of x
+//
+// Expressions hold references to their operands, so they must be evaluated within the full expression that builds
+// them, never kept in an auto variable.
+namespace big_integer_expr {
+
+template <class Expr>
+struct expression {
+  operator big_integer() const {
+    big_integer r;
+    static_cast<const Expr&>(*this).evaluate(r);
+    return r;
+  }
+};
+
+struct operand {
+  const big_integer& value;
+};
+
+inline operand lazy(const big_integer& a) {
+  return {a};
+}
+
+struct product : expression<product> {
+  product(const big_integer& a, const big_integer& b) : a(a), b(b) {}
+
+  void evaluate(big_integer& r) const {
+    mul_add(r, a, b, big_integer());
+  }
+
+  const big_integer& a;
+  const big_integer& b;
+};
+
+struct sum : expression<sum> {
+  sum(const big_integer& a, const big_integer& b) : a(a), b(b) {}
+
+  void evaluate(big_integer& r) const {
+    if (&r == &b) {
+      r += a;
+    } else if (&r == &a) {
+      r += b;
+    } else {
+      r = a;
+      r += b;
+    }
+  }
+
+  const big_integer& a;
+  const big_integer& b;
+};
+
+struct shifted : expression<shifted> {
+  shifted(const big_integer& a, int shift) : a(a), shift(shift) {}
+
+  void evaluate(big_integer& r) const {
+    shl_add(r, a, shift, big_integer());
+  }
+
+  const big_integer& a;
+  int shift;
+};
+
+struct product_sum : expression<product_sum> {
+  product_sum(const product& p, const big_integer& c) : p(p), c(c) {}
+
+  void evaluate(big_integer& r) const {
+    mul_add(r, p.a, p.b, c);
+  }
+
+  product p;
+  const big_integer& c;
+};
+
+struct sum_mod : expression<sum_mod> {
+  sum_mod(const sum& s, const big_integer& m) : s(s), m(m) {}
+
+  void evaluate(big_integer& r) const {
+    add_mod(r, s.a, s.b, m);
+  }
+
+  sum s;
+  const big_integer& m;
+};
+
+struct shifted_sum : expression<shifted_sum> {
+  shifted_sum(const shifted& s, const big_integer& b) : s(s), b(b) {}
+
+  void evaluate(big_integer& r) const {
+    shl_add(r, s.a, s.shift, b);
+  }
+
+  shifted s;
+  const big_integer& b;
+};
+
+// r = e, built in the storage of r
+template <class Expr>
+big_integer& assign(big_integer& r, const expression<Expr>& e) {
+  static_cast<const Expr&>(e).evaluate(r);
+  return r;
+}
+
+// The other operand must be a big_integer, taken by forwarding reference so that temporaries do not make the
+// overloads of big_integer ambiguous; anything else converts the expression to big_integer first.
+template <class T>
+concept big_integer_ref = std::same_as<std::remove_cvref_t<T>, big_integer>;
+
+product operator*(operand a, big_integer_ref auto&& b) {
+  return {a.value, b};
+}
+
+product operator*(big_integer_ref auto&& a, operand b) {
+  return {a, b.value};
+}
+
+sum operator+(operand a, big_integer_ref auto&& b) {
+  return {a.value, b};
+}
+
+sum operator+(big_integer_ref auto&& a, operand b) {
+  return {a, b.value};
+}
+
+inline shifted operator<<(operand a, int shift) {
+  return {a.value, shift};
+}
+
+product_sum operator+(const product& p, big_integer_ref auto&& c) {
+  return {p, c};
+}
+
+product_sum operator+(big_integer_ref auto&& c, const product& p) {
+  return {p, c};
+}
+
+sum_mod operator%(const sum& s, big_integer_ref auto&& m) {
+  return {s, m};
+}
+
+shifted_sum operator+(const shifted& s, big_integer_ref auto&& b) {
+  return {s, b};
+}
+
+shifted_sum operator+(big_integer_ref auto&& b, const shifted& s) {
+  return {s, b};
+}
+
+} // namespace big_integer_expr
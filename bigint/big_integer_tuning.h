@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+// Operand sizes, in limbs, at which big_integer switches to the next multiplication algorithm.
+// Measured on x86-64 with a Release build and 64-bit limbs.
+
+inline constexpr size_t KARATSUBA_THRESHOLD = 32;
+inline constexpr size_t KARATSUBA_SQR_THRESHOLD = 48;
+
+inline constexpr size_t TOOM3_THRESHOLD = 150;
+inline constexpr size_t TOOM4_THRESHOLD = 400;
+
+inline constexpr size_t NTT_THRESHOLD = 7000;
+
+// Product size per thread, in limbs, below which an NTT multiplication takes no more threads.
+inline constexpr size_t PARALLEL_MUL_THRESHOLD = 8192;
+
+// Divisor size at which division switches from schoolbook to the recursive algorithm.
+inline constexpr size_t DIV_BZ_THRESHOLD = 60;
+
+// Modulus size at which Barrett reduction switches from short schoolbook products to full multiplications.
+inline constexpr size_t BARRETT_THRESHOLD = 250;
+
+// Operand size at which gcd switches from Lehmer steps to the recursive half-gcd.
+inline constexpr size_t HGCD_THRESHOLD = 300;
+
+// Number size at which decimal conversion switches from repeated division by 10^19 to recursive splitting.
+inline constexpr size_t TO_STRING_THRESHOLD = 30;
+
+// Length, in 19-digit chunks, at which decimal parsing switches from multiply-and-add to recursive splitting.
+inline constexpr size_t FROM_STRING_THRESHOLD = 40;
+
+// Operand size, in limbs, at which additions and subtractions switch from adc chains to the AVX2/AVX-512 kernels.
+inline constexpr size_t VECTOR_ADD_THRESHOLD = 16;
+
+// Number of limbs multiplied one at a time at the leaves of the product trees of factorial, binomial and primorial.
+inline constexpr size_t PRODUCT_TREE_LEAF = 16;
+
+// Argument below which factorial multiplies the odd numbers directly instead of recursing on the prime swing.
+inline constexpr unsigned FACTORIAL_SWING_THRESHOLD = 80;
@@ -4,6 +4,7 @@
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 big_integer_gmp::big_integer_gmp() {
   mpz_init(mpz);
@@ -185,8 +186,43 @@ bool operator>=(const big_integer_gmp& a, const big_integer_gmp& b) {
   return mpz_cmp(a.mpz, b.mpz) >= 0;
 }
 
-std::string to_string(const big_integer_gmp& a) {
-  char* tmp = mpz_get_str(nullptr, 10, a.mpz);
+big_integer_gmp pow_mod(const big_integer_gmp& base, const big_integer_gmp& exp, const big_integer_gmp& mod) {
+  big_integer_gmp r;
+  mpz_powm(r.mpz, base.mpz, exp.mpz, mod.mpz);
+  return r;
+}
+
+big_integer_gmp gcd(const big_integer_gmp& a, const big_integer_gmp& b) {
+  big_integer_gmp r;
+  mpz_gcd(r.mpz, a.mpz, b.mpz);
+  return r;
+}
+
+// 0 if a is not invertible modulo m
+big_integer_gmp mod_inverse(const big_integer_gmp& a, const big_integer_gmp& m) {
+  big_integer_gmp r;
+  if (!mpz_invert(r.mpz, a.mpz, m.mpz)) {
+    mpz_set_ui(r.mpz, 0);
+  }
+  return r;
+}
+
+big_integer_gmp iroot(const big_integer_gmp& a, unsigned n) {
+  big_integer_gmp r;
+  mpz_root(r.mpz, a.mpz, n);
+  return r;
+}
+
+std::vector<uint8_t> export_bytes(const big_integer_gmp& a, std::endian order) {
+  std::vector<uint8_t> r((mpz_sizeinbase(a.mpz, 2) + 7) / 8);
+  size_t count = 0;
+  mpz_export(r.data(), &count, order == std::endian::big ? 1 : -1, 1, 0, 0, a.mpz);
+  r.resize(count);
+  return r;
+}
+
+std::string to_string(const big_integer_gmp& a, int base) {
+  char* tmp = mpz_get_str(nullptr, base, a.mpz);
   std::string res = tmp;
 
   void (*freefunc)(void*, size_t);
@@ -2,8 +2,11 @@
 
 #include <gmp.h>
 
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <vector>
 
 struct big_integer_gmp {
   big_integer_gmp();
@@ -58,7 +61,12 @@ struct big_integer_gmp {
   friend bool operator<=(const big_integer_gmp& a, const big_integer_gmp& b);
   friend bool operator>=(const big_integer_gmp& a, const big_integer_gmp& b);
 
-  friend std::string to_string(const big_integer_gmp& a);
+  friend std::string to_string(const big_integer_gmp& a, int base);
+  friend big_integer_gmp pow_mod(const big_integer_gmp& base, const big_integer_gmp& exp, const big_integer_gmp& mod);
+  friend big_integer_gmp gcd(const big_integer_gmp& a, const big_integer_gmp& b);
+  friend big_integer_gmp mod_inverse(const big_integer_gmp& a, const big_integer_gmp& m);
+  friend big_integer_gmp iroot(const big_integer_gmp& a, unsigned n);
+  friend std::vector<uint8_t> export_bytes(const big_integer_gmp& a, std::endian order);
 
 private:
   mpz_t mpz;
@@ -84,5 +92,10 @@ bool operator>(const big_integer_gmp& a, const big_integer_gmp& b);
 bool operator<=(const big_integer_gmp& a, const big_integer_gmp& b);
 bool operator>=(const big_integer_gmp& a, const big_integer_gmp& b);
 
-std::string to_string(const big_integer_gmp& a);
+std::string to_string(const big_integer_gmp& a, int base = 10);
+big_integer_gmp pow_mod(const big_integer_gmp& base, const big_integer_gmp& exp, const big_integer_gmp& mod);
+big_integer_gmp gcd(const big_integer_gmp& a, const big_integer_gmp& b);
+big_integer_gmp mod_inverse(const big_integer_gmp& a, const big_integer_gmp& m);
+big_integer_gmp iroot(const big_integer_gmp& a, unsigned n);
+std::vector<uint8_t> export_bytes(const big_integer_gmp& a, std::endian order);
 std::ostream& operator<<(std::ostream& s, const big_integer_gmp& a);
@@ -1,4 +1,5 @@
 #include "../big_integer.h"
+#include "../fixed_big_integer.h"
 #include "big_integer_gmp.h"
 
 #include <gtest/gtest.h>
@@ -7,6 +8,8 @@
 #include <cassert>
 #include <cstdlib>
 #include <random>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -128,6 +131,44 @@ TEST(correctness_random, div_randomized) {
   }
 }
 
+namespace {
+big_integer rand_decimal(size_t digits, std::mt19937& rng) {
+  std::string str(digits, '0');
+  for (char& ch : str) {
+    ch = static_cast<char>('0' + rng() % 10);
+  }
+  return big_integer(str);
+}
+
+big_integer rand_bytes(size_t size, std::mt19937& rng) {
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) {
+    byte = static_cast<uint8_t>(rng());
+  }
+  return import_bytes(bytes.data(), bytes.size());
+}
+} // namespace
+
+TEST(correctness_random, mul_ntt) {
+  std::mt19937 rng(42);
+  big_integer a = rand_decimal(60000, rng);
+  big_integer b = rand_decimal(40000, rng);
+  big_integer ab = a * b;
+  EXPECT_EQ(a, ab / b);
+  EXPECT_EQ(ab * ab, (a * a) * (b * b));
+}
+
+TEST(correctness_random, mul_ntt_threads) {
+  // 17500 + 7500 limbs of 64 bits split into three shares
+  std::mt19937 rng(7);
+  big_integer a = rand_bytes(140000, rng);
+  big_integer b = -rand_bytes(60000, rng);
+  big_integer ab = a * b;
+  set_multiplication_threads(3);
+  EXPECT_EQ(ab, a * b);
+  set_multiplication_threads(1);
+}
+
 TEST(correctness_random, cmp) {
   std::default_random_engine rng(42);
   for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
@@ -180,6 +221,43 @@ TEST(correctness_random, mul) {
   }
 }
 
+TEST(correctness_random, mul_karatsuba) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a, b;
+    a.random(MAX_SIZE * 8, rng);
+    b.random(MAX_SIZE * (itn + 1), rng);
+    big_integer_gmp c = a * b;
+    big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+    EXPECT_EQ(to_string(c), to_string(R));
+  }
+}
+
+TEST(correctness_random, sqr_karatsuba) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    big_integer_gmp c = a * a;
+    big_integer A = big_integer(to_string(a));
+    EXPECT_EQ(to_string(c), to_string(A * A));
+  }
+}
+
+TEST(correctness_random, mul_toom_cook) {
+  std::default_random_engine rng(1337);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS / 2; ++itn) {
+    big_integer_gmp a, b;
+    size_t size = MAX_SIZE * (itn * 2 + 4);
+    a.random(size, rng);
+    b.random(size - rng() % MAX_SIZE, rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+    EXPECT_EQ(to_string(a * a), to_string(A * A));
+  }
+}
+
 TEST(correctness_random, div) {
   std::default_random_engine rng(322);
   for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
@@ -212,6 +290,19 @@ TEST(correctness_random, mod) {
   }
 }
 
+TEST(correctness_random, div_recursive) {
+  std::default_random_engine rng(2718);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS / 2; ++itn) {
+    big_integer_gmp a, b;
+    b.random(MAX_SIZE * (itn * 2 + 2), rng);
+    a.random(MAX_SIZE * (itn * 5 + 4), rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+  }
+}
+
 TEST(correctness_random, bitwise) {
   std::default_random_engine rng(42);
   for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
@@ -229,6 +320,13 @@ TEST(correctness_random, bitwise) {
     c = a ^ b;
     R = big_integer(to_string(a)) ^ big_integer(to_string(b));
     EXPECT_EQ(to_string(c), to_string(R));
+
+    // a zero low limb makes ~, ++ and -- borrow across limbs
+    c = a << 128;
+    R = big_integer(to_string(c));
+    EXPECT_EQ(to_string(~c), to_string(~R));
+    EXPECT_EQ(to_string(++big_integer_gmp(c)), to_string(++big_integer(R)));
+    EXPECT_EQ(to_string(--big_integer_gmp(c)), to_string(--big_integer(R)));
   }
 }
 
@@ -244,3 +342,194 @@ TEST(correctness_random, bit_shifts) {
     EXPECT_EQ(to_string(a >> shift), to_string(R >> shift));
   }
 }
+
+TEST(correctness_random, pow_mod) {
+  std::default_random_engine rng(1009);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp base, exp, mod;
+    base.random(MAX_SIZE * 2, rng);
+    exp.random(MAX_SIZE, rng);
+    mod.random(MAX_SIZE / (itn + 1), rng);
+    if (exp < 0) {
+      exp = -exp;
+    }
+    if (itn % 2 == 0 && (mod & 1) == 0) {
+      ++mod;
+    }
+    big_integer R = pow_mod(big_integer(to_string(base)), big_integer(to_string(exp)), big_integer(to_string(mod)));
+    EXPECT_EQ(to_string(pow_mod(base, exp, mod)), to_string(R));
+  }
+}
+
+TEST(correctness_random, modulus_reduce) {
+  std::default_random_engine rng(4242);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp m;
+    m.random(MAX_SIZE * (itn + 1) / 4, rng);
+    big_integer_modulus M(big_integer(to_string(m)));
+    for (size_t i = 0; i != NUMBER_OF_ITERATIONS; ++i) {
+      big_integer_gmp x;
+      x.random(MAX_SIZE * (i + 1) / 2, rng);
+      EXPECT_EQ(to_string(x % m), to_string(M.reduce(big_integer(to_string(x)))));
+    }
+  }
+}
+
+TEST(correctness_random, gcd) {
+  std::default_random_engine rng(7919);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a, b, c;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    b.random(MAX_SIZE * (itn + 1) / 2, rng);
+    c.random(MAX_SIZE * itn, rng);
+    a *= c;
+    b *= c;
+    big_integer A(to_string(a)), B(to_string(b)), x, y;
+    big_integer g = extended_gcd(A, B, x, y);
+    EXPECT_EQ(to_string(gcd(a, b)), to_string(g));
+    EXPECT_EQ(g, gcd(A, B));
+    EXPECT_EQ(A * x + B * y, g);
+    if (b != 0 && gcd(a, b) == 1) {
+      EXPECT_EQ(to_string(mod_inverse(a, b)), to_string(mod_inverse(A, B)));
+    }
+  }
+}
+
+TEST(correctness_random, iroot) {
+  std::default_random_engine rng(6151);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    unsigned n = static_cast<unsigned>(itn % 2 == 0 ? itn / 2 + 2 : rng() % 100 + 1);
+    if (n % 2 == 0 && a < 0) {
+      a = -a;
+    }
+    big_integer A(to_string(a));
+    EXPECT_EQ(to_string(iroot(a, n)), to_string(iroot(A, n)));
+    if (a >= 0) {
+      EXPECT_EQ(to_string(iroot(a, 2)), to_string(isqrt(A)));
+    }
+  }
+}
+
+TEST(correctness_random, export_import_bytes) {
+  std::default_random_engine rng(3301);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    big_integer A(to_string(a));
+    for (std::endian order : {std::endian::big, std::endian::little}) {
+      std::vector<uint8_t> bytes = export_bytes(a, order);
+      EXPECT_EQ(bytes, export_bytes(A, order));
+      EXPECT_EQ(to_string(a < 0 ? -a : a), to_string(import_bytes(bytes.data(), bytes.size(), order)));
+    }
+    std::vector<uint8_t> wire;
+    serialize(A, wire);
+    size_t used = 0;
+    EXPECT_EQ(to_string(a), to_string(deserialize(wire.data(), wire.size(), used)));
+    EXPECT_EQ(wire.size(), used);
+  }
+}
+
+TEST(correctness_random, string_conv_radix) {
+  std::default_random_engine rng(5741);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    big_integer A(to_string(a));
+    for (int base : {2, 8, 16, 32}) {
+      std::string s = to_string(a, base);
+      EXPECT_EQ(s, to_string(A, base));
+      EXPECT_EQ(to_string(a), to_string(big_integer(s, base)));
+    }
+  }
+}
+
+TEST(correctness_random, stream_output) {
+  std::default_random_engine rng(8123);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a;
+    a.random(MAX_SIZE * (itn + 1) * 4, rng);
+    big_integer A(to_string(a));
+    std::ostringstream out;
+    out << A << ' ' << std::oct << A;
+    EXPECT_EQ(to_string(a) + " " + to_string(a, 8), out.str());
+
+    std::string s(to_string(a).size(), ' ');
+    std::to_chars_result res = to_chars(s.data(), s.data() + s.size(), A);
+    EXPECT_EQ(res.ec, std::errc());
+    EXPECT_EQ(to_string(a), s);
+  }
+}
+
+TEST(correctness_random, fused) {
+  std::default_random_engine rng(9049);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a, b, c, m;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    b.random(MAX_SIZE * (itn % 3 + 1), rng);
+    c.random(MAX_SIZE * (itn + 2), rng);
+    m.random(MAX_SIZE * (itn + 1) / (itn % 2 + 1), rng);
+    big_integer A(to_string(a)), B(to_string(b)), C(to_string(c)), M(to_string(m));
+    int shift = static_cast<int>(rng() % MAX_SIZE);
+    big_integer R;
+    mul_add(R, A, B, C);
+    EXPECT_EQ(to_string(a * b + c), to_string(R));
+    add_mod(R, A, C, M);
+    EXPECT_EQ(to_string((a + c) % m), to_string(R));
+    add_mod(R, A % M, B % M, M);
+    EXPECT_EQ(to_string((a % m + b % m) % m), to_string(R));
+    shl_add(R, A, shift, C);
+    EXPECT_EQ(to_string((a << shift) + c), to_string(R));
+  }
+}
+
+TEST(correctness_random, addmul) {
+  std::default_random_engine rng(5147);
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS; ++itn) {
+    big_integer_gmp a, b, c;
+    a.random(MAX_SIZE * (itn + 1), rng);
+    b.random(MAX_SIZE * (itn % 3 + 1), rng);
+    c.random(MAX_SIZE * (itn + 2), rng);
+    unsigned long k = rng();
+    big_integer A(to_string(a)), B(to_string(b)), C(to_string(c));
+    big_integer R = C;
+    addmul(R, A, B);
+    EXPECT_EQ(to_string(c + a * b), to_string(R));
+    submul(R, A, B);
+    EXPECT_EQ(to_string(c), to_string(R));
+    submul(R, B, A);
+    EXPECT_EQ(to_string(c - b * a), to_string(R));
+    R = C;
+    addmul_ui(R, A, k);
+    EXPECT_EQ(to_string(c + a * big_integer_gmp(std::to_string(k))), to_string(R));
+    submul_ui(R, B, k);
+    EXPECT_EQ(to_string(c + (a - b) * big_integer_gmp(std::to_string(k))), to_string(R));
+  }
+}
+
+TEST(correctness_random, fixed_big_integer) {
+  using u512 = fixed_big_integer<512>;
+  std::default_random_engine rng(7321);
+  big_integer mod = big_integer(1) << 512;
+  for (size_t itn = 0; itn != NUMBER_OF_ITERATIONS * 2; ++itn) {
+    big_integer_gmp a, b;
+    a.random(rng() % 512 + 1, rng);
+    b.random(rng() % 512 + 1, rng);
+    big_integer A(to_string(a)), B(to_string(b));
+    A = (A % mod + mod) % mod;
+    B = (B % mod + mod) % mod;
+    u512 x(A), y(B);
+    int shift = static_cast<int>(rng() % 600);
+    EXPECT_EQ(big_integer(x + y), (A + B) % mod);
+    EXPECT_EQ(big_integer(x - y), (A - B + mod) % mod);
+    EXPECT_EQ(big_integer(x * y), A * B % mod);
+    EXPECT_EQ(big_integer(mul_wide(x, y)), A * B);
+    EXPECT_EQ(big_integer(x << shift), (A << shift) % mod);
+    EXPECT_EQ(big_integer(x >> shift), A >> shift);
+    if (B != 0) {
+      EXPECT_EQ(big_integer(x / y), A / B);
+      EXPECT_EQ(big_integer(x % y), A % B);
+    }
+  }
+}
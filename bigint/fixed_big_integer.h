@@ -0,0 +1,302 @@
+#pragma once
+
+#include "big_integer.h"
+#include "limb_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// An unsigned integer of exactly Bits bits, kept in a std::array of limbs. Arithmetic wraps modulo 2^Bits like the
+// built-in unsigned types. There is no heap buffer, sign or trim(): every operation runs a fixed number of limb steps
+// of the kernels in limb_kernels.h, which the compiler unrolls, and all of them are constexpr.
+template <size_t Bits>
+struct fixed_big_integer {
+  static_assert(Bits > 0 && Bits % std::numeric_limits<limb_t>::digits == 0,
+                "Bits must be a multiple of the limb width");
+
+  static constexpr size_t LIMBS = Bits / std::numeric_limits<limb_t>::digits;
+
+  constexpr fixed_big_integer() = default;
+
+  // a modulo 2^Bits, negative values wrap like a conversion to an unsigned type
+  template <std::integral T>
+  constexpr fixed_big_integer(T a) {
+    using namespace limb_kernels;
+    dlimb_t value = dlimb_cast(a);
+    limb_t fill = 0;
+    if constexpr (std::is_signed_v<T>) {
+      fill = a < 0 ? ~limb_t(0) : 0;
+    }
+    for (size_t i = 0; i < LIMBS; i++) {
+      _data[i] = i < 2 ? limb_cast(value >> (i * EXP)) : fill;
+    }
+  }
+
+  // the limbs, least significant first
+  explicit constexpr fixed_big_integer(const std::array<limb_t, LIMBS>& limbs) : _data(limbs) {}
+
+  // a modulo 2^Bits, negative values wrap like a conversion to an unsigned type
+  explicit fixed_big_integer(const big_integer& a) {
+    std::copy_n(a._data.begin(), std::min(a.length(), LIMBS), _data.begin());
+    if (a._sign) {
+      *this = -*this;
+    }
+  }
+
+  explicit operator big_integer() const {
+    big_integer result;
+    result._data.assign(_data.data(), _data.data() + LIMBS);
+    result.trim();
+    return result;
+  }
+
+  constexpr fixed_big_integer& operator+=(const fixed_big_integer& rhs) {
+    limb_kernels::add_n_scalar(_data.data(), _data.data(), rhs._data.data(), LIMBS, 0);
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator-=(const fixed_big_integer& rhs) {
+    limb_kernels::sub_n_scalar(_data.data(), _data.data(), rhs._data.data(), LIMBS, 0);
+    return *this;
+  }
+
+  // schoolbook product with the rows cut at LIMBS limbs, the wrapped-out part is never computed
+  constexpr fixed_big_integer& operator*=(const fixed_big_integer& rhs) {
+    fixed_big_integer result;
+    for (size_t i = 0; i < LIMBS; i++) {
+      limb_kernels::addmul_limbs(result._data.data() + i, _data.data(), LIMBS - i, rhs._data[i]);
+    }
+    return *this = result;
+  }
+
+  constexpr fixed_big_integer& operator/=(const fixed_big_integer& rhs) {
+    fixed_big_integer remainder;
+    divide(*this, remainder, *this, rhs);
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator%=(const fixed_big_integer& rhs) {
+    fixed_big_integer quotient;
+    divide(quotient, *this, *this, rhs);
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator&=(const fixed_big_integer& rhs) {
+    for (size_t i = 0; i < LIMBS; i++) {
+      _data[i] &= rhs._data[i];
+    }
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator|=(const fixed_big_integer& rhs) {
+    for (size_t i = 0; i < LIMBS; i++) {
+      _data[i] |= rhs._data[i];
+    }
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator^=(const fixed_big_integer& rhs) {
+    for (size_t i = 0; i < LIMBS; i++) {
+      _data[i] ^= rhs._data[i];
+    }
+    return *this;
+  }
+
+  // shifts by Bits or more leave zero
+  constexpr fixed_big_integer& operator<<=(int rhs) {
+    auto [big_shift, small_shift] = split_shift(rhs);
+    if (big_shift >= LIMBS) {
+      return *this = 0;
+    }
+    std::copy_backward(_data.begin(), _data.end() - big_shift, _data.end());
+    std::fill_n(_data.begin(), big_shift, 0);
+    if (small_shift != 0) {
+      limb_kernels::lshift_limbs(_data.data() + big_shift, _data.data() + big_shift, LIMBS - big_shift, small_shift);
+    }
+    return *this;
+  }
+
+  constexpr fixed_big_integer& operator>>=(int rhs) {
+    auto [big_shift, small_shift] = split_shift(rhs);
+    if (big_shift >= LIMBS) {
+      return *this = 0;
+    }
+    std::copy(_data.begin() + big_shift, _data.end(), _data.begin());
+    std::fill(_data.end() - big_shift, _data.end(), 0);
+    if (small_shift != 0) {
+      limb_kernels::rshift_limbs(_data.data(), _data.data(), LIMBS - big_shift, small_shift);
+    }
+    return *this;
+  }
+
+  constexpr fixed_big_integer operator+() const {
+    return *this;
+  }
+
+  constexpr fixed_big_integer operator-() const {
+    return fixed_big_integer() - *this;
+  }
+
+  constexpr fixed_big_integer operator~() const {
+    fixed_big_integer result;
+    for (size_t i = 0; i < LIMBS; i++) {
+      result._data[i] = ~_data[i];
+    }
+    return result;
+  }
+
+  constexpr fixed_big_integer& operator++() {
+    return *this += 1;
+  }
+
+  constexpr fixed_big_integer operator++(int) {
+    fixed_big_integer result = *this;
+    ++*this;
+    return result;
+  }
+
+  constexpr fixed_big_integer& operator--() {
+    return *this -= 1;
+  }
+
+  constexpr fixed_big_integer operator--(int) {
+    fixed_big_integer result = *this;
+    --*this;
+    return result;
+  }
+
+  // the limbs, least significant first
+  constexpr const std::array<limb_t, LIMBS>& limbs() const {
+    return _data;
+  }
+
+  friend constexpr fixed_big_integer operator+(fixed_big_integer a, const fixed_big_integer& b) {
+    return a += b;
+  }
+
+  friend constexpr fixed_big_integer operator-(fixed_big_integer a, const fixed_big_integer& b) {
+    return a -= b;
+  }
+
+  friend constexpr fixed_big_integer operator*(fixed_big_integer a, const fixed_big_integer& b) {
+    return a *= b;
+  }
+
+  friend constexpr fixed_big_integer operator/(fixed_big_integer a, const fixed_big_integer& b) {
+    return a /= b;
+  }
+
+  friend constexpr fixed_big_integer operator%(fixed_big_integer a, const fixed_big_integer& b) {
+    return a %= b;
+  }
+
+  friend constexpr fixed_big_integer operator&(fixed_big_integer a, const fixed_big_integer& b) {
+    return a &= b;
+  }
+
+  friend constexpr fixed_big_integer operator|(fixed_big_integer a, const fixed_big_integer& b) {
+    return a |= b;
+  }
+
+  friend constexpr fixed_big_integer operator^(fixed_big_integer a, const fixed_big_integer& b) {
+    return a ^= b;
+  }
+
+  friend constexpr fixed_big_integer operator<<(fixed_big_integer a, int b) {
+    return a <<= b;
+  }
+
+  friend constexpr fixed_big_integer operator>>(fixed_big_integer a, int b) {
+    return a >>= b;
+  }
+
+  friend constexpr bool operator==(const fixed_big_integer& a, const fixed_big_integer& b) = default;
+
+  friend constexpr std::strong_ordering operator<=>(const fixed_big_integer& a, const fixed_big_integer& b) {
+    return limb_kernels::cmp_limbs(a._data.data(), b._data.data(), LIMBS) <=> 0;
+  }
+
+  // q = a / b, r = a % b; throws std::invalid_argument if b is zero. q and r may be a or b.
+  friend constexpr void divide(fixed_big_integer& q, fixed_big_integer& r, const fixed_big_integer& a,
+                               const fixed_big_integer& b) {
+    using namespace limb_kernels;
+    size_t n = b.length();
+    if (n == 0) {
+      throw std::invalid_argument("Cannot divide by zero");
+    }
+    size_t m = a.length();
+    fixed_big_integer quotient;
+    fixed_big_integer remainder;
+    if (n == 1) {
+      remainder._data[0] = divrem_1_limbs(quotient._data.data(), a._data.data(), m, b._data[0]);
+    } else if (m >= n) {
+      // Knuth's algorithm D on copies shifted so that the top bit of the divisor is set
+      size_t shift = std::countl_zero(b._data[n - 1]);
+      std::array<limb_t, LIMBS + 1> u{};
+      std::array<limb_t, LIMBS> d{};
+      std::copy_n(a._data.begin(), m, u.begin());
+      std::copy_n(b._data.begin(), n, d.begin());
+      if (shift != 0) {
+        u[m] = lshift_limbs(u.data(), u.data(), m, shift);
+        lshift_limbs(d.data(), d.data(), n, shift);
+      }
+      quotient._data[m + 1 - n] = divrem_basecase(quotient._data.data(), u.data(), m + 1 - n, d.data(), n);
+      if (shift != 0) {
+        rshift_limbs(u.data(), u.data(), n, shift);
+      }
+      std::copy_n(u.begin(), n, remainder._data.begin());
+    } else {
+      remainder = a;
+    }
+    q = quotient;
+    r = remainder;
+  }
+
+  friend std::string to_string(const fixed_big_integer& a, int base = 10) {
+    return to_string(big_integer(a), base);
+  }
+
+  friend std::ostream& operator<<(std::ostream& out, const fixed_big_integer& a) {
+    return out << big_integer(a);
+  }
+
+private:
+  // number of limbs up to the highest nonzero one
+  constexpr size_t length() const {
+    size_t n = LIMBS;
+    while (n > 0 && _data[n - 1] == 0) {
+      n--;
+    }
+    return n;
+  }
+
+  static constexpr std::pair<size_t, size_t> split_shift(int shift) {
+    if (shift < 0) {
+      throw std::invalid_argument("Negative shift");
+    }
+    return {static_cast<size_t>(shift) / limb_kernels::EXP, static_cast<size_t>(shift) % limb_kernels::EXP};
+  }
+
+  std::array<limb_t, LIMBS> _data{};
+};
+
+// The full 2 * Bits-bit product of a and b
+template <size_t Bits>
+constexpr fixed_big_integer<2 * Bits> mul_wide(const fixed_big_integer<Bits>& a, const fixed_big_integer<Bits>& b) {
+  constexpr size_t n = fixed_big_integer<Bits>::LIMBS;
+  std::array<limb_t, 2 * n> r{};
+  for (size_t i = 0; i < n; i++) {
+    r[i + n] = limb_kernels::addmul_limbs(r.data() + i, a.limbs().data(), n, b.limbs()[i]);
+  }
+  return fixed_big_integer<2 * Bits>(r);
+}
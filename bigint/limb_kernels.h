@@ -0,0 +1,221 @@
+#pragma once
+
+#include "limb_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// x86-64 with 64-bit limbs adds through adc chains outside constant evaluation; the macro is undefined at the end
+#if defined(__x86_64__) && defined(__GNUC__) && defined(__SIZEOF_INT128__) && !defined(BIG_INTEGER_32BIT_LIMBS)
+#define LIMB_KERNELS_DETAIL_ADC
+#include <immintrin.h>
+#endif
+
+namespace limb_kernels {
+
+// a product of two limbs
+#if defined(__SIZEOF_INT128__) && !defined(BIG_INTEGER_32BIT_LIMBS)
+__extension__ typedef unsigned __int128 dlimb_t;
+#else
+using dlimb_t = uint64_t;
+#endif
+static_assert(sizeof(dlimb_t) == 2 * sizeof(limb_t));
+
+inline constexpr size_t EXP = std::numeric_limits<limb_t>::digits;
+inline constexpr dlimb_t BASE = dlimb_t{1} << EXP;
+
+template <typename T>
+constexpr limb_t limb_cast(T value) {
+  return static_cast<limb_t>(value & std::numeric_limits<limb_t>::max());
+}
+
+template <typename T>
+constexpr dlimb_t dlimb_cast(T value) {
+  return static_cast<dlimb_t>(value);
+}
+
+// Portable limb-array kernels, shared by big_integer.cpp and fixed_big_integer. They are constexpr, the x86 adc chains
+// are taken only outside constant evaluation. All arrays are little-endian, `r` may alias `a` where noted.
+
+// r[0..n) = a[0..n) + b[0..n) + carry, returns the carry out; r may alias a or b
+constexpr limb_t add_n_scalar(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t carry) {
+#ifdef LIMB_KERNELS_DETAIL_ADC
+  if (!std::is_constant_evaluated()) {
+    unsigned char c = carry;
+    unsigned long long t;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      c = _addcarry_u64(c, a[i], b[i], &t);
+      r[i] = t;
+      c = _addcarry_u64(c, a[i + 1], b[i + 1], &t);
+      r[i + 1] = t;
+      c = _addcarry_u64(c, a[i + 2], b[i + 2], &t);
+      r[i + 2] = t;
+      c = _addcarry_u64(c, a[i + 3], b[i + 3], &t);
+      r[i + 3] = t;
+    }
+    for (; i < n; i++) {
+      c = _addcarry_u64(c, a[i], b[i], &t);
+      r[i] = t;
+    }
+    return c;
+  }
+#endif
+  dlimb_t cur_carry = carry;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = dlimb_cast(a[i]) + b[i] + cur_carry;
+    r[i] = limb_cast(cur);
+    cur_carry = cur >> EXP;
+  }
+  return limb_cast(cur_carry);
+}
+
+// r[0..n) = a[0..n) - b[0..n) - borrow, returns the borrow out; r may alias a or b
+constexpr limb_t sub_n_scalar(limb_t* r, const limb_t* a, const limb_t* b, size_t n, limb_t borrow) {
+#ifdef LIMB_KERNELS_DETAIL_ADC
+  if (!std::is_constant_evaluated()) {
+    unsigned char c = borrow;
+    unsigned long long t;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      c = _subborrow_u64(c, a[i], b[i], &t);
+      r[i] = t;
+      c = _subborrow_u64(c, a[i + 1], b[i + 1], &t);
+      r[i + 1] = t;
+      c = _subborrow_u64(c, a[i + 2], b[i + 2], &t);
+      r[i + 2] = t;
+      c = _subborrow_u64(c, a[i + 3], b[i + 3], &t);
+      r[i + 3] = t;
+    }
+    for (; i < n; i++) {
+      c = _subborrow_u64(c, a[i], b[i], &t);
+      r[i] = t;
+    }
+    return c;
+  }
+#endif
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = dlimb_cast(a[i]) - b[i] - borrow;
+    r[i] = limb_cast(cur);
+    borrow = (cur >> EXP) != 0;
+  }
+  return borrow;
+}
+
+constexpr int cmp_limbs(const limb_t* a, const limb_t* b, size_t n) {
+  for (size_t i = n; i > 0; i--) {
+    if (a[i - 1] != b[i - 1]) {
+      return a[i - 1] < b[i - 1] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+// r[0..n) += a[0..n) * b, returns the high limb
+constexpr limb_t addmul_limbs(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+  dlimb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = r[i] + dlimb_cast(a[i]) * b + carry;
+    r[i] = limb_cast(cur);
+    carry = cur >> EXP;
+  }
+  return limb_cast(carry);
+}
+
+// r[0..n) -= a[0..n) * b, returns the borrow limb
+constexpr limb_t submul_limbs(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+  dlimb_t borrow = 0;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t prod = dlimb_cast(a[i]) * b + borrow;
+    limb_t lo = limb_cast(prod);
+    borrow = (prod >> EXP) + (r[i] < lo);
+    r[i] -= lo;
+  }
+  return limb_cast(borrow);
+}
+
+// r[0..n) = a[0..n) * b, returns the high limb; r may alias a
+constexpr limb_t mul_1_limbs(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+  dlimb_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    dlimb_t cur = dlimb_cast(a[i]) * b + carry;
+    r[i] = limb_cast(cur);
+    carry = cur >> EXP;
+  }
+  return limb_cast(carry);
+}
+
+// q[0..n) = a[0..n) / d, returns the remainder; q may alias a
+constexpr limb_t divrem_1_limbs(limb_t* q, const limb_t* a, size_t n, limb_t d) {
+  dlimb_t rem = 0;
+  for (size_t i = n; i > 0; i--) {
+    dlimb_t cur = (rem << EXP) | a[i - 1];
+    q[i - 1] = limb_cast(cur / d);
+    rem = cur % d;
+  }
+  return limb_cast(rem);
+}
+
+// r[0..n) = a[0..n) << shift, 0 < shift < EXP, returns the bits shifted out; r may alias a or start above it
+constexpr limb_t lshift_limbs(limb_t* r, const limb_t* a, size_t n, size_t shift) {
+  if (n == 0) {
+    return 0;
+  }
+  limb_t out = a[n - 1] >> (EXP - shift);
+  for (size_t i = n - 1; i > 0; i--) {
+    r[i] = (a[i] << shift) | (a[i - 1] >> (EXP - shift));
+  }
+  r[0] = a[0] << shift;
+  return out;
+}
+
+// r[0..n) = a[0..n) >> shift, 0 < shift < EXP; r may alias a or start below it
+constexpr void rshift_limbs(limb_t* r, const limb_t* a, size_t n, size_t shift) {
+  if (n == 0) {
+    return;
+  }
+  for (size_t i = 0; i + 1 < n; i++) {
+    r[i] = (a[i] >> shift) | (a[i + 1] << (EXP - shift));
+  }
+  r[n - 1] = a[n - 1] >> shift;
+}
+
+// Schoolbook division (Knuth, algorithm D) of a[0..n+m) by a normalized d[0..n), n >= 2.
+// q[0..m) receives the low limbs of the quotient, a[0..n) the remainder; returns the top quotient limb (0 or 1).
+constexpr limb_t divrem_basecase(limb_t* q, limb_t* a, size_t m, const limb_t* d, size_t n) {
+  limb_t q_top = 0;
+  if (cmp_limbs(a + m, d, n) >= 0) {
+    sub_n_scalar(a + m, a + m, d, n, 0);
+    q_top = 1;
+  }
+  dlimb_t d1 = d[n - 1];
+  dlimb_t d2 = d[n - 2];
+  for (size_t j = m; j > 0; j--) {
+    limb_t* cur = a + j - 1;
+    dlimb_t top = (dlimb_cast(cur[n]) << EXP) | cur[n - 1];
+    dlimb_t q_hat = top / d1;
+    dlimb_t r_hat = top % d1;
+    if (q_hat >= BASE) {
+      q_hat = BASE - 1;
+      r_hat = top - q_hat * d1;
+    }
+    while (r_hat < BASE && q_hat * d2 > ((r_hat << EXP) | cur[n - 2])) {
+      --q_hat;
+      r_hat += d1;
+    }
+    limb_t borrow = submul_limbs(cur, d, n, limb_cast(q_hat));
+    if (cur[n] < borrow) {
+      --q_hat;
+      add_n_scalar(cur, cur, d, n, 0);
+    }
+    cur[n] = 0;
+    q[j - 1] = limb_cast(q_hat);
+  }
+  return q_top;
+}
+
+} // namespace limb_kernels
+
+#undef LIMB_KERNELS_DETAIL_ADC
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+// 64-bit limbs need 128-bit products, other targets (or BIG_INTEGER_32BIT_LIMBS) use 32-bit limbs
+#if defined(__SIZEOF_INT128__) && !defined(BIG_INTEGER_32BIT_LIMBS)
+using limb_t = uint64_t;
+#else
+using limb_t = uint32_t;
+#endif
+
+// Limb storage of big_integer: values of up to three 64-bit words are kept inline, longer ones spill to the heap.
+class limb_vector {
+public:
+  using value_type = limb_t;
+
+  using reference = limb_t&;
+  using const_reference = const limb_t&;
+
+  using pointer = limb_t*;
+  using const_pointer = const limb_t*;
+
+  using iterator = pointer;
+  using const_iterator = const_pointer;
+
+  static constexpr size_t SMALL_SIZE = 24 / sizeof(limb_t);
+
+public:
+  limb_vector() noexcept {}
+
+  explicit limb_vector(size_t size) {
+    resize(size);
+  }
+
+  limb_vector(const_iterator first, const_iterator last) {
+    assign(first, last);
+  }
+
+  limb_vector(std::initializer_list<limb_t> init) {
+    assign(init.begin(), init.end());
+  }
+
+  limb_vector(const limb_vector& other) {
+    assign(other.begin(), other.end());
+  }
+
+  limb_vector(limb_vector&& other) noexcept {
+    steal(other);
+  }
+
+  limb_vector& operator=(const limb_vector& other) {
+    if (&other != this) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  limb_vector& operator=(limb_vector&& other) noexcept {
+    if (&other != this) {
+      release();
+      steal(other);
+    }
+    return *this;
+  }
+
+  ~limb_vector() noexcept {
+    release();
+  }
+
+  reference operator[](size_t index) {
+    assert(index < size());
+    return data()[index];
+  }
+
+  const_reference operator[](size_t index) const {
+    assert(index < size());
+    return data()[index];
+  }
+
+  pointer data() noexcept {
+    return is_small() ? _static_data : _dynamic_data;
+  }
+
+  const_pointer data() const noexcept {
+    return is_small() ? _static_data : _dynamic_data;
+  }
+
+  size_t size() const noexcept {
+    return _size;
+  }
+
+  size_t capacity() const noexcept {
+    return _capacity;
+  }
+
+  bool empty() const noexcept {
+    return _size == 0;
+  }
+
+  reference back() {
+    assert(!empty());
+    return data()[_size - 1];
+  }
+
+  const_reference back() const {
+    assert(!empty());
+    return data()[_size - 1];
+  }
+
+  iterator begin() noexcept {
+    return data();
+  }
+
+  iterator end() noexcept {
+    return data() + _size;
+  }
+
+  const_iterator begin() const noexcept {
+    return data();
+  }
+
+  const_iterator end() const noexcept {
+    return data() + _size;
+  }
+
+  void push_back(limb_t value) {
+    if (_size == _capacity) {
+      grow(std::max(_capacity, SMALL_SIZE) * 2);
+    }
+    data()[_size++] = value;
+  }
+
+  void pop_back() {
+    assert(!empty());
+    _size--;
+  }
+
+  // new limbs are zero
+  void resize(size_t new_size) {
+    if (new_size > _capacity) {
+      grow(std::max(new_size, std::max(_capacity, SMALL_SIZE) * 2));
+    }
+    if (new_size > _size) {
+      std::fill(data() + _size, data() + new_size, 0);
+    }
+    _size = new_size;
+  }
+
+  void reserve(size_t new_capacity) {
+    if (new_capacity > _capacity) {
+      grow(new_capacity);
+    }
+  }
+
+  void assign(size_t count, limb_t value) {
+    _size = 0;
+    resize(count);
+    std::fill(begin(), end(), value);
+  }
+
+  void assign(const_iterator first, const_iterator last) {
+    size_t count = last - first;
+    _size = 0;
+    reserve(count);
+    std::copy(first, last, data());
+    _size = count;
+  }
+
+  iterator insert(const_iterator pos, size_t count, limb_t value) {
+    size_t index = pos - begin();
+    size_t old_size = _size;
+    resize(_size + count);
+    std::copy_backward(begin() + index, begin() + old_size, end());
+    std::fill(begin() + index, begin() + index + count, value);
+    return begin() + index;
+  }
+
+  void clear() noexcept {
+    _size = 0;
+  }
+
+  void swap(limb_vector& other) noexcept {
+    limb_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  friend void swap(limb_vector& lhs, limb_vector& rhs) noexcept {
+    lhs.swap(rhs);
+  }
+
+  friend bool operator==(const limb_vector& lhs, const limb_vector& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend bool operator!=(const limb_vector& lhs, const limb_vector& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  bool is_small() const noexcept {
+    return _capacity == SMALL_SIZE;
+  }
+
+  void grow(size_t new_capacity) {
+    limb_t* new_data = new limb_t[new_capacity];
+    std::copy(begin(), end(), new_data);
+    release();
+    _dynamic_data = new_data;
+    _capacity = new_capacity;
+  }
+
+  void release() noexcept {
+    if (!is_small()) {
+      delete[] _dynamic_data;
+      _capacity = SMALL_SIZE;
+    }
+  }
+
+  void steal(limb_vector& other) noexcept {
+    if (other.is_small()) {
+      std::copy(other.begin(), other.end(), _static_data);
+    } else {
+      _dynamic_data = other._dynamic_data;
+      _capacity = other._capacity;
+      other._capacity = SMALL_SIZE;
+    }
+    _size = other._size;
+    other._size = 0;
+  }
+
+private:
+  size_t _size{0};
+  size_t _capacity{SMALL_SIZE};
+
+  union {
+    limb_t _static_data[SMALL_SIZE];
+    limb_t* _dynamic_data;
+  };
+};
@@ -1,12 +1,17 @@
 #include "big_integer.h"
+#include "big_integer_expr.h"
+#include "fixed_big_integer.h"
 #include "gtest/gtest.h"
 
 #include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdlib>
+#include <iomanip>
 #include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -117,6 +122,44 @@ TEST(correctness, assignment_return_value) {
   EXPECT_TRUE(b == 7);
 }
 
+TEST(correctness, assignment_small_and_long) {
+  big_integer small = 42;
+  big_integer long_value("123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890");
+  big_integer a = small;
+  a = long_value;
+  EXPECT_EQ(long_value, a);
+  a = small;
+  EXPECT_EQ(small, a);
+
+  big_integer b = long_value;
+  b /= long_value / 1000;
+  EXPECT_EQ(1000, b);
+  b *= long_value;
+  EXPECT_EQ(long_value * 1000, b);
+}
+
+TEST(correctness, rvalue_operands) {
+  big_integer a("-123456789012345678901234567890123456789");
+  big_integer b("98765432109876543210987654321");
+  big_integer sum = a + b;
+  big_integer product = a * b;
+
+  EXPECT_EQ(sum, big_integer(a) + b);
+  EXPECT_EQ(sum, a + big_integer(b));
+  EXPECT_EQ(sum, big_integer(a) + big_integer(b));
+  EXPECT_EQ(product, big_integer(a) * big_integer(b));
+  EXPECT_EQ(a - b, big_integer(a) - b);
+  EXPECT_EQ(a / b, big_integer(a) / b);
+  EXPECT_EQ(a % b, big_integer(a) % b);
+  EXPECT_EQ(a + a, a + big_integer(a));
+  EXPECT_EQ(a + b * 2, sum + b + (a - a) * product);
+
+  big_integer c = std::move(a);
+  a = std::move(b);
+  b = c;
+  EXPECT_EQ(sum, a + b);
+}
+
 TEST(correctness, comparisons) {
   big_integer a = 100;
   big_integer b = 100;
@@ -139,6 +182,9 @@ TEST(correctness, compare_zero_and_minus_zero) {
   big_integer b = -a;
 
   EXPECT_TRUE(a == b);
+  EXPECT_FALSE(b < a);
+  EXPECT_FALSE(a > b);
+  EXPECT_TRUE(b >= a);
 }
 
 TEST(correctness, add) {
@@ -332,6 +378,16 @@ TEST(correctness, decrement) {
   EXPECT_EQ(41, post);
 }
 
+TEST(correctness, increment_decrement_borrow) {
+  big_integer a = big_integer(1) << 64;
+  --a;
+  EXPECT_EQ(a, big_integer("18446744073709551615"));
+  big_integer b = -(big_integer(1) << 64);
+  ++b;
+  EXPECT_EQ(b, big_integer("-18446744073709551615"));
+  EXPECT_EQ(~-(big_integer(1) << 128), (big_integer(1) << 128) - 1);
+}
+
 TEST(correctness, and_) {
   big_integer a = 0x55;
   big_integer b = 0xaa;
@@ -421,6 +477,18 @@ TEST(correctness, xor_signed) {
   EXPECT_TRUE((a ^ (b - 256)) == (0x66 - 256));
 }
 
+TEST(correctness, xor_signed2) {
+  big_integer a("-18446744073709551616"); // -(1 << 64)
+  big_integer b("-340282366920938463463374607431768211456"); // -(1 << 128)
+
+  EXPECT_EQ(a, a & a);
+  EXPECT_EQ(b, a & b);
+  EXPECT_EQ(a, a | b);
+  EXPECT_EQ(big_integer("340282366920938463444927863358058659840"), a ^ b);
+  EXPECT_EQ(-1, -1 & -1);
+  EXPECT_EQ(big_integer("18446744073709551617"), (a - 1) ^ -2);
+}
+
 TEST(correctness, xor_return_value) {
   big_integer a = 1;
 
@@ -487,6 +555,33 @@ TEST(correctness, shr_return_value) {
   EXPECT_EQ(8, a);
 }
 
+TEST(correctness, shift_whole_limbs) {
+  big_integer a("340282366920938463463374607431768211455"); // (1 << 128) - 1
+
+  EXPECT_EQ(a, a << 0);
+  EXPECT_EQ(a, a >> 0);
+  EXPECT_EQ(a * big_integer("18446744073709551616"), a << 64);
+  EXPECT_EQ(big_integer("18446744073709551615"), a >> 64);
+  EXPECT_EQ(a, a << 96 >> 96);
+}
+
+TEST(correctness, shr_past_the_end) {
+  big_integer a("-340282366920938463463374607431768211455");
+
+  EXPECT_EQ(0, -a >> 1000);
+  EXPECT_EQ(-1, a >> 1000);
+  EXPECT_EQ(-1, a >> 128);
+  EXPECT_EQ(-256, a >> 120);
+  EXPECT_EQ(big_integer("-18446744073709551616"), (a - 1) >> 64);
+}
+
+TEST(correctness, shift_negative_count) {
+  big_integer a = 5;
+
+  EXPECT_THROW(a << -1, std::invalid_argument);
+  EXPECT_THROW(a >> -1, std::invalid_argument);
+}
+
 TEST(correctness, add_long) {
   big_integer a("10000000000000000000000000000000000000000000000000000000000000"
                 "000000000000000000000000000000");
@@ -543,6 +638,21 @@ TEST(correctness, sub_long_pow2) {
   EXPECT_EQ(1, a - b);
 }
 
+TEST(correctness, add_sub_carry_chains) {
+  for (int bits = 32; bits <= 64 * 40; bits += 32) {
+    big_integer p = big_integer(1) << bits;
+    big_integer ones = p - 1;
+
+    EXPECT_EQ(p, ones + 1);
+    EXPECT_EQ(p, 1 + ones);
+    EXPECT_EQ(ones, p - 1);
+    EXPECT_EQ(-1, ones - p);
+    EXPECT_EQ(p + p, ones + ones + 2);
+    EXPECT_EQ(-ones, 1 - p);
+    EXPECT_EQ("0", to_string(-ones + ones));
+  }
+}
+
 TEST(correctness, mul_long) {
   big_integer a("10000000000000000000000000000000000000000000000000000000000000"
                 "000000000000000000000000000000");
@@ -554,6 +664,230 @@ TEST(correctness, mul_long) {
   EXPECT_EQ(c, a * b);
 }
 
+TEST(correctness, fused) {
+  big_integer a("-123456789012345678901234567890");
+  big_integer b("98765432109876543210");
+  big_integer c("1000000000000000000000000000000000000000000000");
+  big_integer r;
+  for (const big_integer& x : {a, b, c, -c, big_integer(0)}) {
+    mul_add(r, a, b, x);
+    EXPECT_EQ(r, a * b + x);
+    mul_add(r, x, x, a);
+    EXPECT_EQ(r, x * x + a);
+    add_mod(r, a, x, b);
+    EXPECT_EQ(r, (a + x) % b);
+    add_mod(r, c, x, -b);
+    EXPECT_EQ(r, (c + x) % b);
+    shl_add(r, a, 130, x);
+    EXPECT_EQ(r, (a << 130) + x);
+    shl_add(r, x, 64, a);
+    EXPECT_EQ(r, (x << 64) + a);
+  }
+  mul_add(r, a, b, -(a * b));
+  EXPECT_EQ(r, 0);
+  EXPECT_THROW(add_mod(r, a, b, 0), std::invalid_argument);
+  EXPECT_THROW(shl_add(r, a, -1, b), std::invalid_argument);
+
+  big_integer x = a;
+  mul_add(x, x, b, x);
+  EXPECT_EQ(x, a * b + a);
+  x = a;
+  mul_add(x, b, x, c);
+  EXPECT_EQ(x, b * a + c);
+  x = c;
+  add_mod(x, x, a, x);
+  EXPECT_EQ(x, (c + a) % c);
+  x = a;
+  add_mod(x, b, x, c);
+  EXPECT_EQ(x, (b + a) % c);
+  x = a;
+  shl_add(x, x, 70, x);
+  EXPECT_EQ(x, (a << 70) + a);
+  x = b;
+  shl_add(x, a, 3, x);
+  EXPECT_EQ(x, (a << 3) + b);
+}
+
+TEST(correctness, expression_templates) {
+  using big_integer_expr::lazy;
+
+  big_integer a("-123456789012345678901234567890");
+  big_integer b("98765432109876543210");
+  big_integer m("1000000007");
+
+  big_integer x = lazy(a) * b + m;
+  EXPECT_EQ(x, a * b + m);
+  x = m + lazy(a) * b;
+  EXPECT_EQ(x, a * b + m);
+  x = (lazy(a) + b) % m;
+  EXPECT_EQ(x, (a + b) % m);
+  x = (lazy(a) << 100) + big_integer(7);
+  EXPECT_EQ(x, (a << 100) + 7);
+  x = (lazy(a) << 100) - 7;
+  EXPECT_EQ(x, (a << 100) - 7);
+  x = lazy(a) * b;
+  EXPECT_EQ(x, a * b);
+  EXPECT_EQ(big_integer(lazy(a) << 5), a << 5);
+  EXPECT_EQ(big_integer(b + lazy(a)), a + b);
+
+  x = 5;
+  for (int i = 0; i < 100; i++) {
+    assign(x, (lazy(x) + x) % m);
+  }
+  EXPECT_EQ(x, pow_mod(2, 100, m) * 5 % m);
+  assign(x, lazy(x) * x + x);
+  big_integer y = 5 * pow_mod(2, 100, m) % m;
+  EXPECT_EQ(x, y * y + y);
+  assign(x, b + (lazy(x) << 64));
+  EXPECT_EQ(x, ((y * y + y) << 64) + b);
+}
+
+TEST(correctness, addmul) {
+  big_integer a("-123456789012345678901234567890");
+  big_integer b("98765432109876543210");
+  big_integer c = (big_integer(1) << 3000) - 1;
+  for (const big_integer& x : {a, b, c, -c, big_integer(0)}) {
+    for (const big_integer& y : {a, b, c, big_integer(-1), big_integer(0)}) {
+      big_integer r = y;
+      addmul(r, x, b);
+      EXPECT_EQ(r, y + x * b);
+      r = y;
+      submul(r, x, c);
+      EXPECT_EQ(r, y - x * c);
+      r = y;
+      addmul_ui(r, x, 1000000007);
+      EXPECT_EQ(r, y + x * 1000000007);
+      r = y;
+      submul_ui(r, x, std::numeric_limits<unsigned long>::max());
+      EXPECT_EQ(r, y - x * std::numeric_limits<unsigned long>::max());
+    }
+  }
+
+  big_integer r = a * b;
+  submul(r, b, a);
+  EXPECT_EQ(r, 0);
+  r = c * c;
+  submul(r, -c, -c);
+  EXPECT_EQ(r, 0);
+  r = a;
+  addmul(r, r, r);
+  EXPECT_EQ(r, a + a * a);
+  r = c;
+  submul(r, a, r);
+  EXPECT_EQ(r, c - a * c);
+  r = a;
+  addmul_ui(r, r, 3);
+  EXPECT_EQ(r, 4 * a);
+  r = a;
+  submul_ui(r, r, 1);
+  EXPECT_EQ(r, 0);
+}
+
+TEST(correctness, factorial) {
+  big_integer f = 1;
+  for (unsigned n = 0; n <= 600; n++) {
+    f *= n == 0 ? 1 : n;
+    EXPECT_EQ(factorial(n), f);
+  }
+  big_integer g = f;
+  for (unsigned n = 601; n <= 3000; n++) {
+    g *= n;
+  }
+  EXPECT_EQ(factorial(3000), g);
+}
+
+TEST(correctness, binomial) {
+  std::vector<big_integer> row = {1};
+  for (unsigned n = 1; n <= 200; n++) {
+    std::vector<big_integer> next(n + 1, 1);
+    for (unsigned k = 1; k < n; k++) {
+      next[k] = row[k - 1] + row[k];
+    }
+    row = std::move(next);
+    for (unsigned k = 0; k <= n; k++) {
+      EXPECT_EQ(binomial(n, k), row[k]);
+    }
+    EXPECT_EQ(binomial(n, n + 1), 0);
+  }
+  EXPECT_EQ(binomial(0, 0), 1);
+  EXPECT_EQ(binomial(5000, 1234) * factorial(1234) * factorial(3766), factorial(5000));
+}
+
+TEST(correctness, primorial) {
+  EXPECT_EQ(primorial(0), 1);
+  EXPECT_EQ(primorial(1), 1);
+  EXPECT_EQ(primorial(2), 2);
+  EXPECT_EQ(primorial(10), 210);
+  EXPECT_EQ(primorial(30), 6469693230);
+  EXPECT_EQ(primorial(100), big_integer("2305567963945518424753102147331756070"));
+  big_integer p = primorial(1000);
+  EXPECT_EQ(p % 997, 0);
+  EXPECT_EQ(gcd(p, big_integer(1009) * 1013), 1);
+}
+
+TEST(correctness, fixed_big_integer) {
+  using u256 = fixed_big_integer<256>;
+  static_assert(u256(1) + u256(2) == u256(3));
+  static_assert(u256(0) - u256(1) == ~u256(0));
+  static_assert((u256(1) << 255) * u256(2) == u256(0));
+  static_assert((u256(1) << 200) / (u256(1) << 100) == u256(1) << 100);
+  static_assert(((u256(1) << 200) + 12345) % (u256(1) << 100) == u256(12345));
+  static_assert(u256(-1) == ~u256(0));
+  static_assert(u256(3) < u256(1) << 64);
+
+  big_integer mod = big_integer(1) << 256;
+  big_integer a("8000000000000001fedcba9876543210ffffffffffffffff0123456789abcdef", 16);
+  big_integer b("123456789abcdef0123456789abcdef", 16);
+  big_integer c("-1fffffffffffffffffffffffffffffffffffff", 16);
+  u256 x(a), y(b), z(c);
+  EXPECT_EQ(big_integer(z), c + mod);
+  EXPECT_EQ(big_integer(x + y), (a + b) % mod);
+  EXPECT_EQ(big_integer(y - x), b - a + mod);
+  EXPECT_EQ(big_integer(x * y), a * b % mod);
+  EXPECT_EQ(big_integer(x * z), a * (c + mod) % mod);
+  EXPECT_EQ(big_integer(x / y), a / b);
+  EXPECT_EQ(big_integer(x % y), a % b);
+  EXPECT_EQ(big_integer(z / x), (c + mod) / a);
+  EXPECT_EQ(big_integer(x / u256(7)), a / 7);
+  EXPECT_EQ(big_integer(y / x), 0);
+  EXPECT_EQ(big_integer(x % x), 0);
+  EXPECT_EQ(big_integer(x << 77), (a << 77) % mod);
+  EXPECT_EQ(big_integer(x >> 130), a >> 130);
+  EXPECT_EQ(big_integer(x >> 256), 0);
+  EXPECT_EQ(big_integer(x & z), a & (c + mod));
+  EXPECT_EQ(big_integer(x | y), a | b);
+  EXPECT_EQ(big_integer(x ^ z), a ^ (c + mod));
+  EXPECT_EQ(big_integer(mul_wide(x, z)), a * (c + mod));
+  EXPECT_EQ(to_string(x, 16), to_string(a, 16));
+  EXPECT_TRUE(y < x);
+  EXPECT_TRUE(x < z);
+  EXPECT_THROW(x / u256(0), std::invalid_argument);
+  EXPECT_THROW(x << -1, std::invalid_argument);
+}
+
+TEST(correctness, mul_threads) {
+  big_integer a("12345678901234567890123456789");
+  for (int i = 0; i < 16; i++) {
+    a = (a << (8 << i)) + a * 1000000007;
+  }
+  // with 64-bit limbs a has about 9300 limbs and b 7500, both products are NTT ones split between two threads
+  a = (a << 70000) + a;
+  big_integer b = (a >> 110000) - 1;
+  // the products are checked modulo 2^127 - 1 and 2^128, which takes linear time
+  big_integer m = (big_integer(1) << 127) - 1;
+  big_integer low = (big_integer(1) << 128) - 1;
+
+  set_multiplication_threads(3);
+  EXPECT_EQ(3, multiplication_threads());
+  big_integer ab = a * b;
+  EXPECT_EQ(ab % m, (a % m) * (b % m) % m);
+  EXPECT_EQ(ab & low, (a & low) * (b & low) & low);
+  big_integer aa = a * a;
+  EXPECT_EQ(aa % m, (a % m) * (a % m) % m);
+  EXPECT_EQ(aa & low, (a & low) * (a & low) & low);
+  set_multiplication_threads(1);
+}
+
 TEST(correctness, mul_long_signed) {
   big_integer a("-1000000000000000000000000000000000000000000000000000000000000"
                 "000000000000000000000000000000");
@@ -583,6 +917,16 @@ TEST(correctness, mul_long_pow2) {
   EXPECT_EQ(c, b * b);
 }
 
+TEST(correctness, mul_huge_all_ones) {
+  for (int bits : {2000, 40000, 160000, 320000}) {
+    big_integer a = (big_integer(1) << bits) - 1;
+    big_integer c = (big_integer(1) << (2 * bits)) - (big_integer(1) << (bits + 1)) + 1;
+
+    EXPECT_EQ(c, a * a);
+    EXPECT_EQ(c + a, a * (a + 1));
+  }
+}
+
 TEST(correctness, div_0_long) {
   big_integer a;
   big_integer b("100000000000000000000000000000000000000000000000000000000000");
@@ -598,6 +942,17 @@ TEST(correctness, div_long) {
   EXPECT_EQ(c, a / b);
 }
 
+TEST(correctness, div_long_self) {
+  big_integer a("-1000000000000000000000000000000000000000000000000000000000000"
+                "0000000000000000000000000000000");
+  big_integer b = a;
+
+  a /= a;
+  b %= b;
+  EXPECT_EQ(a, 1);
+  EXPECT_EQ(b, 0);
+}
+
 TEST(correctness, div_long_signed) {
   big_integer a("-1000000000000000000000000000000000000000000000000000000000000"
                 "0000000000000000000000000000000");
@@ -664,6 +1019,160 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, string_conv_long) {
+  for (size_t len : {575, 576, 577, 4607, 4608, 4609}) {
+    std::string power_of_ten = "1" + std::string(len, '0');
+    std::string nines(len, '9');
+    EXPECT_EQ(power_of_ten, to_string(big_integer(power_of_ten)));
+    EXPECT_EQ(nines, to_string(big_integer(nines)));
+    EXPECT_EQ("-" + nines, to_string(big_integer("-" + nines)));
+    EXPECT_EQ(big_integer(power_of_ten) - 1, big_integer(nines));
+    EXPECT_EQ(big_integer("-" + power_of_ten), big_integer("-" + std::string(len, '0') + power_of_ten));
+  }
+}
+
+TEST(correctness, string_conv_radix) {
+  big_integer a("-81985529216486895"); // -0x123456789abcdef
+  EXPECT_EQ("-123456789abcdef", to_string(a, 16));
+  EXPECT_EQ("-4432126361152746757", to_string(a, 8));
+  EXPECT_EQ("-28q5cu4qnjff", to_string(a, 32));
+  EXPECT_EQ("1000000000000000000000000000000000000000000000000000000000000000000",
+            to_string(big_integer(1) << 66, 2));
+  EXPECT_EQ("0", to_string(big_integer("-0", 16), 16));
+  EXPECT_EQ(a, big_integer("-123456789ABCDEF", 16));
+  EXPECT_EQ(a, big_integer("-0000000000000000000000000123456789abcdef", 16));
+  EXPECT_EQ(big_integer(1) << 200, big_integer("1" + std::string(40, '0'), 32));
+
+  EXPECT_THROW(big_integer("12", 3), std::invalid_argument);
+  EXPECT_THROW(to_string(a, 36), std::invalid_argument);
+  EXPECT_THROW(big_integer("102", 2), std::invalid_argument);
+  EXPECT_THROW(big_integer("8", 8), std::invalid_argument);
+  EXPECT_THROW(big_integer("fg", 16), std::invalid_argument);
+  EXPECT_THROW(big_integer("w", 32), std::invalid_argument);
+  EXPECT_THROW(big_integer("-", 16), std::invalid_argument);
+
+  big_integer x = (big_integer(1) << 4099) - 12345;
+  for (int base : {2, 8, 10, 16, 32}) {
+    EXPECT_EQ(x, big_integer(to_string(x, base), base));
+    EXPECT_EQ(-x, big_integer(to_string(-x, base), base));
+  }
+}
+
+TEST(correctness, stream_io) {
+  std::stringstream out;
+  out << big_integer(-255) << ' ' << std::hex << big_integer(-255) << ' ' << std::oct << big_integer(8);
+  EXPECT_EQ("-255 -ff 10", out.str());
+
+  big_integer a, b, c, d;
+  std::istringstream in(" -123 +ff 0x1F -0");
+  in >> a >> std::hex >> b >> c >> d;
+  EXPECT_EQ(a, -123);
+  EXPECT_EQ(b, 255);
+  EXPECT_EQ(c, 31);
+  EXPECT_EQ(d, 0);
+  EXPECT_TRUE(in.eof());
+
+  in.clear();
+  in.str("0x10 010 10 z");
+  in.unsetf(std::ios_base::basefield);
+  in >> a >> b >> c;
+  EXPECT_EQ(a, 16);
+  EXPECT_EQ(b, 8);
+  EXPECT_EQ(c, 10);
+  EXPECT_FALSE(in >> d);
+  EXPECT_EQ(d, 0);
+
+  big_integer x = (big_integer(-1) << 5000) + 777;
+  std::stringstream round_trip;
+  round_trip << std::hex << x << ' ' << std::dec << x;
+  round_trip >> std::hex >> a >> std::dec >> b;
+  EXPECT_EQ(a, x);
+  EXPECT_EQ(b, x);
+}
+
+TEST(correctness, stream_format_flags) {
+  // the output of built-in integers with the same flags
+  auto expect_like_int = [](std::ios_base::fmtflags flags, int value, std::streamsize width = 0) {
+    std::ostringstream expected;
+    std::ostringstream actual;
+    expected.flags(flags);
+    actual.flags(flags);
+    expected.fill('*');
+    actual.fill('*');
+    expected.width(width);
+    actual.width(width);
+    expected << value;
+    actual << big_integer(value);
+    EXPECT_EQ(expected.str(), actual.str());
+  };
+  using std::ios_base;
+  for (int value : {0, 255, 0x7abcdef}) {
+    expect_like_int(ios_base::hex | ios_base::showbase, value);
+    expect_like_int(ios_base::hex | ios_base::showbase | ios_base::uppercase, value);
+    expect_like_int(ios_base::hex | ios_base::uppercase, value, 12);
+    expect_like_int(ios_base::oct | ios_base::showbase, value);
+    expect_like_int(ios_base::dec | ios_base::showpos, value);
+    expect_like_int(ios_base::dec | ios_base::showpos | ios_base::internal, value, 12);
+    expect_like_int(ios_base::hex | ios_base::showbase | ios_base::internal, value, 12);
+    expect_like_int(ios_base::hex | ios_base::showbase | ios_base::left, value, 12);
+  }
+  expect_like_int(ios_base::dec | ios_base::showpos, -42);
+  expect_like_int(ios_base::dec | ios_base::internal, -42, 8);
+
+  big_integer x = (big_integer(1) << 3000) + 0xabc;
+  std::stringstream round_trip;
+  round_trip << std::showbase << std::uppercase << std::hex << x << ' ' << std::oct << -x;
+  EXPECT_EQ(round_trip.str().substr(0, 3), "0X1");
+  big_integer a, b;
+  round_trip.unsetf(std::ios_base::basefield);
+  round_trip >> a >> b;
+  EXPECT_EQ(a, x);
+  EXPECT_EQ(b, -x);
+}
+
+TEST(correctness, to_chars) {
+  char buf[32];
+  big_integer a("-123456789012345678901234567890");
+  std::to_chars_result res = to_chars(buf, buf + 31, a);
+  EXPECT_EQ(res.ec, std::errc());
+  EXPECT_EQ("-123456789012345678901234567890", std::string(buf, res.ptr));
+  res = to_chars(buf, buf + 30, a);
+  EXPECT_EQ(res.ec, std::errc::value_too_large);
+  EXPECT_EQ(res.ptr, buf + 30);
+  EXPECT_EQ(to_chars(buf, buf, a).ec, std::errc::value_too_large);
+
+  res = to_chars(buf, buf + 1, big_integer(0));
+  EXPECT_EQ("0", std::string(buf, res.ptr));
+  res = to_chars(buf, buf + 32, -a, 16);
+  EXPECT_EQ(to_string(-a, 16), std::string(buf, res.ptr));
+
+  for (size_t len : {575, 576, 4608, 4609}) {
+    big_integer x("-" + std::string(len, '9'));
+    std::string s(len + 1, ' ');
+    EXPECT_EQ(to_chars(s.data(), s.data() + len, x).ec, std::errc::value_too_large);
+    res = to_chars(s.data(), s.data() + s.size(), x);
+    EXPECT_EQ(res.ptr, s.data() + s.size());
+    EXPECT_EQ(s, to_string(x));
+  }
+}
+
+TEST(correctness, stream_output_long) {
+  for (size_t len : {575, 576, 577, 4607, 4608, 4609, 30000}) {
+    big_integer x = big_integer("1" + std::string(len, '0')) + 1;
+    std::ostringstream out;
+    out << x << ' ' << -x << ' ' << std::hex << x;
+    EXPECT_EQ(to_string(x) + " -" + to_string(x) + " " + to_string(x, 16), out.str());
+  }
+
+  std::ostringstream padded;
+  padded << std::setw(6) << big_integer(-42) << std::left << std::setw(4) << big_integer(7) << '|';
+  EXPECT_EQ("   -427   |", padded.str());
+
+  std::ostream closed(nullptr);
+  closed << big_integer(5);
+  EXPECT_TRUE(closed.bad());
+}
+
 namespace {
 template <typename T>
 void test_converting_ctor(T value) {
@@ -728,3 +1237,201 @@ TEST(correctness, converting_ctor4) {
 
   EXPECT_EQ(to_string(bignum), std::to_string(num));
 }
+
+TEST(correctness, pow_mod) {
+  EXPECT_EQ(pow_mod(4, 13, 497), 445);
+  EXPECT_EQ(pow_mod(-4, 13, 497), 52);
+  EXPECT_EQ(pow_mod(4, 13, -497), 445);
+  EXPECT_EQ(pow_mod(7, 0, 13), 1);
+  EXPECT_EQ(pow_mod(7, 0, 1), 0);
+  EXPECT_EQ(pow_mod(0, 5, 13), 0);
+  EXPECT_EQ(pow_mod(3, 200, 1000), 1);
+
+  // Fermat's little theorem for the Mersenne prime 2^521 - 1
+  big_integer p = (big_integer(1) << 521) - 1;
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  EXPECT_EQ(pow_mod(a, p - 1, p), 1);
+  EXPECT_EQ(pow_mod(a, p, p), a);
+
+  big_integer even = p + 1;
+  EXPECT_EQ(pow_mod(a, 3, even), a * a * a % even);
+}
+
+TEST(correctness, pow_mod_invalid) {
+  EXPECT_THROW(pow_mod(2, 3, 0), std::invalid_argument);
+  EXPECT_THROW(pow_mod(2, -3, 7), std::invalid_argument);
+  EXPECT_THROW(pow_mod(2, -3, 8), std::invalid_argument);
+  EXPECT_THROW(montgomery_context(10), std::invalid_argument);
+}
+
+TEST(correctness, montgomery_context_reuse) {
+  big_integer m("1000000000000000000000000000000000000000000000000000000000000000000007");
+  montgomery_context ctx(m);
+  EXPECT_EQ(ctx.modulus(), m);
+  big_integer x = 1;
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(ctx.pow(2, i), x);
+    EXPECT_EQ(pow_mod(2, i, m), x);
+    x = x * 2 % m;
+  }
+}
+
+TEST(correctness, modulus_reduce) {
+  big_integer_modulus m(7);
+  EXPECT_EQ(m.modulus(), 7);
+  EXPECT_EQ(m.reduce(20), 6);
+  EXPECT_EQ(m.reduce(-20), -6);
+  EXPECT_EQ(m.reduce(0), 0);
+  EXPECT_EQ(big_integer_modulus(-7).reduce(20), 6);
+  EXPECT_THROW(big_integer_modulus(0), std::invalid_argument);
+
+  big_integer p = (big_integer(1) << 521) - 1;
+  big_integer_modulus mp(p);
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  big_integer x = a * a * a * a * a * a * a * a * a * a * a * a * a - 1;
+  EXPECT_EQ(mp.reduce(x), x % p);
+  EXPECT_EQ(mp.reduce(-x), -x % p);
+  EXPECT_EQ(mp.reduce(p * a), 0);
+  EXPECT_EQ(mp.reduce(p * a - 1), p - 1);
+  EXPECT_EQ(mp.reduce(p), 0);
+  EXPECT_EQ(mp.reduce(a), a);
+
+  big_integer_modulus pow2(big_integer(1) << 128);
+  EXPECT_EQ(pow2.reduce(x), x & ((big_integer(1) << 128) - 1));
+}
+
+TEST(correctness, gcd) {
+  EXPECT_EQ(gcd(12, 18), 6);
+  EXPECT_EQ(gcd(-12, 18), 6);
+  EXPECT_EQ(gcd(12, -18), 6);
+  EXPECT_EQ(gcd(0, -5), 5);
+  EXPECT_EQ(gcd(-5, 0), 5);
+  EXPECT_EQ(gcd(0, 0), 0);
+  EXPECT_EQ(gcd(17, 5), 1);
+
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  big_integer b("987654321098765432109876543210987654321098765432109876543210");
+  big_integer g("1234567890123456789");
+  EXPECT_EQ(gcd(a * g, b * g), gcd(a, b) * g);
+
+  big_integer f1 = (big_integer(1) << 20000) - 1;
+  big_integer f2 = (big_integer(1) << 30000) - 1;
+  EXPECT_EQ(gcd(f1, f2), (big_integer(1) << 10000) - 1);
+}
+
+TEST(correctness, extended_gcd) {
+  big_integer x, y;
+  EXPECT_EQ(extended_gcd(240, 46, x, y), 2);
+  EXPECT_EQ(x, -9);
+  EXPECT_EQ(y, 47);
+
+  EXPECT_EQ(extended_gcd(0, -7, x, y), 7);
+  EXPECT_EQ(x, 0);
+  EXPECT_EQ(y, -1);
+  EXPECT_EQ(extended_gcd(-7, 0, x, y), 7);
+  EXPECT_EQ(x, -1);
+  EXPECT_EQ(y, 0);
+  EXPECT_EQ(extended_gcd(0, 0, x, y), 0);
+
+  big_integer a = (big_integer(1) << 20000) - 1;
+  big_integer b = big_integer("-987654321098765432109876543210987654321") << 15000;
+  big_integer g = extended_gcd(a, b, x, y);
+  EXPECT_EQ(g, gcd(a, b));
+  EXPECT_EQ(a * x + b * y, g);
+  EXPECT_LE(x < 0 ? -x : x, (b < 0 ? -b : b) / g / 2);
+}
+
+TEST(correctness, mod_inverse) {
+  EXPECT_EQ(mod_inverse(3, 7), 5);
+  EXPECT_EQ(mod_inverse(-3, 7), 2);
+  EXPECT_EQ(mod_inverse(3, -7), 5);
+  EXPECT_EQ(mod_inverse(10, 1), 0);
+  EXPECT_THROW(mod_inverse(6, 9), std::invalid_argument);
+  EXPECT_THROW(mod_inverse(5, 0), std::invalid_argument);
+
+  big_integer p = (big_integer(1) << 521) - 1;
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  EXPECT_EQ(mod_inverse(a, p) * a % p, 1);
+}
+
+TEST(correctness, isqrt) {
+  EXPECT_EQ(isqrt(0), 0);
+  EXPECT_EQ(isqrt(1), 1);
+  EXPECT_EQ(isqrt(15), 3);
+  EXPECT_EQ(isqrt(16), 4);
+  EXPECT_THROW(isqrt(-1), std::invalid_argument);
+
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  big_integer x = a * a * a * a * a * a * a * a * a * a * a * a * a;
+  big_integer r = isqrt(x);
+  EXPECT_LE(r * r, x);
+  EXPECT_GT((r + 1) * (r + 1), x);
+  EXPECT_EQ(isqrt(x * x), x);
+  EXPECT_EQ(isqrt(x * x - 1), x - 1);
+}
+
+TEST(correctness, iroot) {
+  EXPECT_EQ(iroot(26, 3), 2);
+  EXPECT_EQ(iroot(27, 3), 3);
+  EXPECT_EQ(iroot(-27, 3), -3);
+  EXPECT_EQ(iroot(-26, 3), -2);
+  EXPECT_EQ(iroot(12345, 1), 12345);
+  EXPECT_EQ(iroot(12345, 100), 1);
+  EXPECT_THROW(iroot(-16, 4), std::invalid_argument);
+  EXPECT_THROW(iroot(16, 0), std::invalid_argument);
+
+  big_integer a("123456789012345678901234567890123456789012345678901234567890");
+  big_integer x = a * a * a * a * a * a * a;
+  EXPECT_EQ(iroot(x, 7), a);
+  EXPECT_EQ(iroot(x - 1, 7), a - 1);
+  EXPECT_EQ(iroot(-x, 7), -a);
+  EXPECT_EQ(iroot(big_integer(1) << 1000, 10), big_integer(1) << 100);
+}
+
+TEST(correctness, export_import_bytes) {
+  big_integer a("4759477275222530853130"); // 0x0102030405060708090a
+  std::vector<uint8_t> big = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  std::vector<uint8_t> little(big.rbegin(), big.rend());
+
+  EXPECT_EQ(export_bytes(a), big);
+  EXPECT_EQ(export_bytes(-a, std::endian::little), little);
+  EXPECT_EQ(import_bytes(big.data(), big.size()), a);
+  EXPECT_EQ(import_bytes(little.data(), little.size(), std::endian::little), a);
+  EXPECT_TRUE(export_bytes(0).empty());
+  EXPECT_EQ(import_bytes(nullptr, 0), 0);
+
+  std::vector<uint8_t> padded = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff};
+  EXPECT_EQ(import_bytes(padded.data(), padded.size()), 255);
+  EXPECT_EQ(import_bytes(padded.data(), padded.size(), std::endian::little), big_integer(255) << 72);
+}
+
+TEST(correctness, serialize) {
+  std::vector<big_integer> values = {0, 1, -1, 255, -256, big_integer(1) << 1000,
+                                     big_integer("-123456789012345678901234567890")};
+  std::vector<uint8_t> out;
+  for (const big_integer& x : values) {
+    serialize(x, out);
+  }
+  std::vector<uint8_t> head = {0, 2, 1, 3, 1, 2, 255, 5, 0, 1, 0xfc, 0x01};
+  EXPECT_TRUE(std::equal(head.begin(), head.end(), out.begin()));
+
+  size_t pos = 0;
+  for (const big_integer& x : values) {
+    size_t used = 0;
+    EXPECT_EQ(deserialize(out.data() + pos, out.size() - pos, used), x);
+    pos += used;
+  }
+  EXPECT_EQ(pos, out.size());
+}
+
+TEST(correctness, deserialize_invalid) {
+  size_t used = 0;
+  std::vector<uint8_t> truncated = {6, 1, 2};
+  std::vector<uint8_t> unterminated = {0x80, 0x80};
+  std::vector<uint8_t> overlong(10, 0xff);
+  overlong.push_back(1);
+  EXPECT_THROW(deserialize(nullptr, 0, used), std::invalid_argument);
+  EXPECT_THROW(deserialize(truncated.data(), truncated.size(), used), std::invalid_argument);
+  EXPECT_THROW(deserialize(unterminated.data(), unterminated.size(), used), std::invalid_argument);
+  EXPECT_THROW(deserialize(overlong.data(), overlong.size(), used), std::invalid_argument);
+}